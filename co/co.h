@@ -116,6 +116,7 @@
 typedef struct coStruct *co;
 typedef const struct coStruct *cco;
 typedef struct coFnStruct *coFn;
+typedef struct co_writer_struct *coWriter;
 
 typedef int (*coInitFn)(co o, void *data);
 typedef long (*coSizeFn)(cco o);
@@ -130,6 +131,15 @@ struct co_avl_node_struct // structure to build the AVL tree for the "map"
   void *value;
   struct co_avl_node_struct *kid[2];
   int height;
+  long size; // number of nodes in this subtree, used for coMapSize() and index access
+};
+
+struct co_mem_block_struct // memory block of the memory image object
+{
+  uint64_t address;
+  size_t len;
+  size_t memlen; // allocated memory, 0 if data is not owned by the block (arena)
+  unsigned char *data;
 };
 
 #define CO_NONE 0
@@ -144,6 +154,14 @@ struct co_avl_node_struct // structure to build the AVL tree for the "map"
 #define CO_STRDUP 4
 #define CO_STRFREE 8
 
+/* set by the ...WithArena() constructors: the object (and its vector list, map
+  nodes and string bytes) is owned by a coArena. coDelete() will not release
+  such an object, instead all objects are released together by coDeleteArena()
+*/
+#define CO_ARENA 16
+
+typedef struct co_arena_struct *coArena;
+
 struct coStruct {
   coFn fn;
   unsigned flags; // see above, e.g. CO_NONE, CO_FREE_VALS, etc...
@@ -157,7 +175,26 @@ struct coStruct {
     struct // map
     {
       struct co_avl_node_struct *root;
+      coArena arena; // only used if CO_ARENA is set
     } m;
+    struct // hash map
+    {
+      struct co_hash_struct *table; // NULL for an empty hash map
+    } h;
+    struct // memory image
+    {
+      struct co_mem_block_struct *block; // sorted by address, blocks don't overlap and are not adjacent
+      size_t cnt;
+      size_t max;
+    } i;
+    struct // table
+    {
+      struct co_table_struct *table;
+    } t;
+    struct // string pool
+    {
+      struct co_str_pool_struct *pool;
+    } p;
     struct // string and memory block
     {
       char *str;
@@ -192,6 +229,10 @@ extern coFn coMemType;
 extern coFn coMapType;
 extern coFn coDblType;
 extern coFn coBoolType;         // only there to support json files better
+extern coFn coHashMapType;
+extern coFn coMemImageType;
+extern coFn coTableType;
+extern coFn coStrPoolType;
 
 /* object construction */
 
@@ -206,6 +247,20 @@ co coNewVectorByMap(
               // a vector with two elements, the key and the value
 co coNewMap(unsigned flags);		// CO_FREE_VALS, CO_STRDUP, CO_STRFREE
 co coNewBool(int n);
+co coNewHashMap(unsigned flags);	// CO_FREE_VALS, CO_STRDUP, CO_STRFREE
+co coNewMemImage(void);
+co coNewTable(void);
+co coNewStrPool(void);
+
+/* object construction within an arena (see below), a==NULL will create
+ * normal objects */
+
+co coNewStrWithArena(coArena a, unsigned flags, const char *s); // CO_STRDUP will copy s into the arena
+co coNewDblWithArena(coArena a, double n);
+co coNewVectorWithArena(coArena a, unsigned flags);
+co coNewMapWithArena(coArena a, unsigned flags);
+co coNewBoolWithArena(coArena a, int n);
+co coNewMemWithArena(coArena a, unsigned flags, const void *mem, size_t len); // CO_STRDUP will copy mem into the arena
 
 /* object type test procedures */
 
@@ -217,6 +272,10 @@ co coNewBool(int n);
 #define coIsMap(o) (coGetType(o) == coMapType)
 #define coIsDbl(o) (coGetType(o) == coDblType)
 #define coIsBool(o) (coGetType(o) == coBoolType)
+#define coIsHashMap(o) (coGetType(o) == coHashMapType)
+#define coIsMemImage(o) (coGetType(o) == coMemImageType)
+#define coIsTable(o) (coGetType(o) == coTableType)
+#define coIsStrPool(o) (coGetType(o) == coStrPoolType)
 
 /* generic object functions */
 
@@ -226,16 +285,113 @@ void coDelete(
 co coClone(cco o); // do a deep copy of the object "o"
 long coSize(cco o);
 
-/* JSON read/write */
+/* arena allocator
+
+  An arena allocates memory in large chunks. All memory is released at once
+  with coDeleteArena(). Objects created within an arena (e.g. by
+  coReadA2LByFPWithArena()) are not released by coDelete(), instead the whole
+  object tree is released by coDeleteArena(). Elements added to an arena vector
+  or arena map should be arena objects of the same arena.
+  An arena is not thread safe.
+
+  coArena a = coNewArena(0);
+  co a2l = coReadA2LByFPWithArena(fp, a);
+  ...
+  coDeleteArena(a);  // releases a2l
+*/
+
+coArena coNewArena(size_t chunk_size); // chunk_size==0: use default size
+void coDeleteArena(coArena a);
+void *coArenaMalloc(coArena a, size_t size); // returns NULL for memory error
+char *coArenaStrDup(coArena a, const char *s);
+char *coArenaStrDupWithLen(coArena a, const char *s, size_t len);
+size_t coArenaSize(coArena a); // number of bytes allocated from the OS
+const unsigned char *coArenaMapFile(coArena a, FILE *fp, size_t *len); // read-only mapping of the file, released by coDeleteArena(), NULL if mmap is not available
+
+/* JSON read/write
+
+  The read functions keep all parser state inside a local reader, so
+  different threads may read JSON files at the same time.
+*/
 
 co coReadJSONByString(const char *json);
 co coReadJSONByFP(FILE *fp); // supports UTF-8 BOM and detects GZIP (if
                              // CO_USE_ZLIB is enabled)
+co coReadJSONByStringWithArena(const char *json, coArena a);
+co coReadJSONByFPWithArena(FILE *fp, coArena a); // uses coReaderInitByMmap() if possible, strings are copied into the arena
 void coWriteJSON(cco o, int isCompact, int isUTF8,
                  FILE *fp); // isUTF8 is 0, then output char codes >=128 via \u
+void coWriteJSONByWriter(cco o, int isCompact, int isUTF8, coWriter w);
+size_t coWriteJSONSize(cco o, int isCompact, int isUTF8); // size of the output without '\0'
+char *coWriteJSONToMem(cco o, int isCompact, int isUTF8, size_t *len); // exactly one malloc, result must be free'd, len can be NULL
+char *coWriteJSONToString(cco o, int isCompact, int isUTF8); // same as coWriteJSONToMem()
+#ifdef CO_USE_ZLIB
+int coWriteJSONGz(cco o, int isCompact, int isUTF8, FILE *fp, int level); // level: 0..9 or Z_DEFAULT_COMPRESSION
+char *coWriteJSONToGzMem(cco o, int isCompact, int isUTF8, int level, size_t *len); // result must be free'd
+#endif
+
+/* binary read/write
+
+  compact binary format for all object types, including memory blocks.
+  Strings are stored together with the '\0' terminator: If the file can be
+  mapped (coReadBinaryByFPWithArena()), then strings and memory blocks are not
+  copied. Within an arena, a hash map is restored as map.
+*/
+void coWriteBinaryByWriter(cco o, coWriter w);
+int coWriteBinary(cco o, FILE *fp); // returns 0 for write error
+size_t coWriteBinarySize(cco o);
+char *coWriteBinaryToMem(cco o, size_t *len); // exactly one malloc, result must be free'd, len can be NULL
+#ifdef CO_USE_ZLIB
+int coWriteBinaryGz(cco o, FILE *fp, int level); // level: 0..9 or Z_DEFAULT_COMPRESSION
+#endif
+co coReadBinaryByFP(FILE *fp); // detects GZIP (if CO_USE_ZLIB is enabled)
+co coReadBinaryByFPWithArena(FILE *fp, coArena a); // uses coReaderInitByMmap() if possible
+co coReadBinaryByMem(const void *mem, size_t len);
+co coReadBinaryByMemWithArena(const void *mem, size_t len, coArena a);
+
+/* JSON event interface
+
+  Instead of building the co object tree, the callback function is called
+  for each element of the JSON file:
+    CO_JSON_START_MAP, CO_JSON_KEY, ..., CO_JSON_END_MAP
+    CO_JSON_START_ARRAY, ..., CO_JSON_END_ARRAY
+    CO_JSON_STR, CO_JSON_DBL, CO_JSON_BOOL, CO_JSON_NULL
+  If the callback returns CO_JSON_MATERIALIZE for CO_JSON_START_MAP or
+  CO_JSON_START_ARRAY, then the complete map or array is read as co object
+  and delivered with CO_JSON_OBJECT (instead of the events for the content and
+  the END event). The callback must delete this object.
+  Memory usage depends only on the nesting depth and the materialized objects.
+*/
+#define CO_JSON_START_MAP 1
+#define CO_JSON_END_MAP 2
+#define CO_JSON_KEY 3
+#define CO_JSON_START_ARRAY 4
+#define CO_JSON_END_ARRAY 5
+#define CO_JSON_STR 6
+#define CO_JSON_DBL 7
+#define CO_JSON_BOOL 8
+#define CO_JSON_NULL 9
+#define CO_JSON_OBJECT 10
+
+/* return values of the callback */
+#define CO_JSON_ABORT 0
+#define CO_JSON_CONTINUE 1
+#define CO_JSON_MATERIALIZE 2
+
+struct co_json_event_struct {
+  int event; // CO_JSON_START_MAP, ...
+  int depth; // nesting level, 0 for the top level value, keys have the same depth as their values
+  const char *str; // CO_JSON_KEY and CO_JSON_STR, only valid during the callback
+  double n; // CO_JSON_DBL, CO_JSON_BOOL (0 or 1)
+  co o; // CO_JSON_OBJECT
+};
+typedef int (*coJSONEventCB)(const struct co_json_event_struct *ev, void *data);
+
+int coReadJSONEventsByString(const char *json, coJSONEventCB cb, void *data);
+int coReadJSONEventsByFP(FILE *fp, coJSONEventCB cb, void *data);
 
 /* string functions */
-co coNewStrWithLen(const char *s, size_t len);
+co coNewStrWithLen(const char *s, size_t len); // copy len bytes, s may contain '\0'
 
 int coStrAdd(co o, const char *s); // concats the given string to the string
                                    // object, requires the CO_STRDUP flag
@@ -249,6 +405,8 @@ int coStrSet(co o, const char *s); /* change the string of a string object, requ
 /* memory functions */
 long coMemSize(cco o);
 int coMemAdd(co o, const void *mem, size_t len);
+int coMemReserve(co o, size_t memlen); // reserve space for memlen bytes, large blocks are mmap'ed
+int coMemShrink(co o); // release unused memory after coMemReserve()
 const void *coMemGet(cco o);
 
 /* double functions */
@@ -264,6 +422,7 @@ long coVectorAdd(co o, cco p); // add object at the end of the list, returns -1
     // p will be moved and deleted by the vector destructor if CO_FREE_VALS is set, 
 	// p can be NULL pointer
 int coVectorAppendVector(co v, cco src); // append elements from src to vector v, elements are cloned, this means CO_FREE_VALS should be set for v
+int coVectorMoveVector(co v, co src); // move all elements from src to the end of v (no clone), src will be empty
 cco coVectorGet(cco o, long idx); // return object at specific position from the vector
 void coVectorSet(co v, long i, cco e); // replace an element within the vector, the index must be lower than coVectorSize()
 void coVectorErase(
@@ -311,7 +470,13 @@ coMapGetKey(cco o, const char *key); // returns the internal pointer to the key
 void coMapErase(co o, const char *key); // removes object from the map
 void coMapClear(co o); // delete all elements and clear the array
 int coMapEmpty(cco o); // return 1 if the map is empty, return 0 otherwise
-long coMapSize(cco o); // O(n) !!
+long coMapSize(cco o); // O(1)
+
+/* access by index, the index refers to the sorted order of the keys (same as
+ * the idx argument of the coMapForEach callback), O(log n) */
+cco coMapGetByIndex(cco o, long idx); // returns NULL if idx is out of range
+const char *coMapGetKeyByIndex(cco o, long idx); // returns NULL if idx is out of range
+long coMapIndexOfKey(cco o, const char *key); // returns -1 if key doesn't exist
 
 typedef int (*coMapForEachCB)(cco o, long idx, const char *key, cco value,
                               void *data);
@@ -345,6 +510,94 @@ if ( coMapLoopFirst(&iter, o) )
 }
 */
 
+/* hash map functions
+
+  same behavior as the coMap functions above, but with O(1) lookup.
+  coHashMapForEach() visits the elements in insertion order, 
+  coHashMapSortedForEach() visits the elements sorted by key (like 
+  coMapForEach()), coPrint() and coWriteJSON() use the sorted order.
+*/
+const char *coHashMapAdd(co o, const char *key, cco value);
+cco coHashMapAddValueKey(co o, const char *key);
+int coHashMapExists(cco o, const char *key);
+cco coHashMapGet(cco o, const char *key);
+const char *coHashMapGetKey(cco o, const char *key);
+void coHashMapErase(co o, const char *key);
+void coHashMapClear(co o);
+int coHashMapEmpty(cco o);
+long coHashMapSize(cco o); // O(1)
+int coHashMapForEach(cco o, coMapForEachCB cb, void *data); // insertion order
+int coHashMapSortedForEach(cco o, coMapForEachCB cb, void *data); // sorted by key, O(n log n)
+
+/* string pool functions
+
+  A string pool stores each distinct string only once. coStrPoolAdd() returns
+  a string object, which is owned by the pool: It must not be modified and is
+  not released by coDelete(). All strings are released with the pool, so the
+  pool must be deleted after all objects, which refer to the strings.
+  coStrPoolAdd() is lock-free and can be called by several threads for the
+  same pool at the same time. Other functions (including coDelete()) must not
+  be used while another thread adds strings.
+*/
+struct co_str_pool_stat_struct {
+  size_t misses; // number of distinct strings inside the pool
+  size_t hits; // number of coStrPoolAdd() calls, which returned an existing string
+  size_t bytes; // memory for the distinct strings, including '\0'
+  size_t bytes_saved; // memory for the strings, which were found inside the pool
+};
+typedef struct co_str_pool_stat_struct coStrPoolStat;
+
+cco coStrPoolAdd(co o, const char *s, size_t len); // returns NULL for memory error
+long coStrPoolSize(cco o); // number of distinct strings, O(1)
+void coStrPoolGetStat(cco o, coStrPoolStat *stat);
+
+/* memory image functions
+
+  A memory image is a sorted array of memory blocks (address, length, data).
+  coMemImageAdd() merges adjacent and overlapping blocks, the new data
+  replaces the existing data. Lookup by address is O(log n).
+*/
+int coMemImageAdd(co o, uint64_t address, const void *mem, size_t len); // returns 0 for memory error
+long coMemImageSize(cco o); // number of memory blocks
+int coMemImageReserve(co o, uint64_t address, size_t len); // reserve space up to address+len in the block, which contains address
+int coMemImageShrink(co o); // release unused memory of all blocks
+const struct co_mem_block_struct *coMemImageGetBlock(cco o, long idx); // NULL if idx is out of range
+long coMemImageFind(cco o, uint64_t address); // index of the block, which contains address, or -1
+const unsigned char *coMemImageGet(cco o, uint64_t address, size_t len); // NULL if [address, address+len) is not inside one block
+co coNewMapByMemImage(cco o); // same map as returned by coReadS19ByFP()
+
+/* table functions
+
+  A table stores values column by column. Double and integer columns are
+  contiguous arrays, the strings of all string columns are stored in one
+  buffer of the table and are referenced by offset. coSize() returns the
+  number of rows.
+  Values are added with coTableAddField(), one value per column and row. The
+  text is converted according to the column type:
+    CO_COL_DBL: empty or illegal values are stored as NaN
+    CO_COL_INT: empty or illegal values are stored as 0
+    CO_COL_AUTO: the values are kept as strings until coTableFinish() converts
+      the column into an integer column (all values are integers), a double
+      column (all values are numbers or empty) or a string column
+  coTableFinish() must be called before the values are accessed.
+*/
+#define CO_COL_AUTO 0
+#define CO_COL_INT 1
+#define CO_COL_DBL 2
+#define CO_COL_STR 3
+
+long coTableAddCol(co o, const char *name, int type); // returns the column index, -1 for memory error
+int coTableAddField(co o, long col, const char *s, size_t len); // s[len] must be '\0', returns 0 for memory error
+int coTableFinish(co o); // resolve CO_COL_AUTO columns, returns 0 for memory error
+long coTableSize(cco o); // number of rows
+long coTableColCnt(cco o);
+long coTableFindCol(cco o, const char *name); // column index or -1
+const char *coTableColName(cco o, long col);
+int coTableColType(cco o, long col); // CO_COL_INT, CO_COL_DBL or CO_COL_STR
+const int64_t *coTableGetInt(cco o, long col); // values of an integer column, NULL for other columns
+const double *coTableGetDbl(cco o, long col); // values of a double column, NULL for other columns
+const char *coTableGetStr(cco o, long col, long row); // value of a string column, NULL for other columns or illegal row
+
 /* file / string reader interface */
 
 #define BOM_NONE 0
@@ -357,55 +610,260 @@ if ( coMapLoopFirst(&iter, o) )
 typedef struct co_reader_struct *coReader;
 typedef void (*coReaderNextFn)(coReader r);
 
+/*
+  The reader provides the current char ("curr") and a window [ptr, end) with
+  the chars which follow "curr". coReaderNext() takes the next char from the
+  window and calls next_cb only if the window is empty. next_cb will refill
+  the window (string, plain file and gzip reader) or deliver a single char
+  (UTF-16 reader, the window remains empty).
+  Parsers may scan the window directly and consume a span of chars with
+  coReaderSkip().
+*/
+#define CO_READER_BUF_SIZE (32 * 1024)
+#define COJ_STR_BUF 1024
+
 struct co_reader_struct {
   int curr;
+  const unsigned char *ptr; // next char after curr, ptr == end: window is empty
+  const unsigned char *end; // end of the window
+  coArena arena; // if not NULL, objects will be created inside this arena
+  co pool; // if not NULL, the A2L reader stores each distinct token only once in this hash map (CO_STRDUP) or string pool
   int bom; // see constants above
   const char *reader_string;
   FILE *fp;
   coReaderNextFn next_cb;
+  int is_in_place; // window is a read-only mapping of the whole file owned by "arena", see coReaderInitByMmap()
   unsigned char stack_memory[16];  // this is normal last in first out stack for UTF-8 sequence
   int stack_pos;		// stack size, 0 means, stack is empty
+  char str_buf[COJ_STR_BUF + 16]; // scratch buffer for the JSON parser, extra data for UTF-8 sequence and \0
+  unsigned char buf[CO_READER_BUF_SIZE]; // window memory for file and gzip reader
 #ifdef CO_USE_ZLIB
 #define CHUNK (16 * 1024)
-  unsigned have;
-  unsigned pos;
   z_stream strm;
   unsigned char in[CHUNK];
-  unsigned char out[CHUNK];
 #endif /* CO_USE_ZLIB */
 };
 
 int coReaderInitByString(coReader reader, const char *s);
+int coReaderInitByMem(coReader reader, const char *s, size_t len); // s is not required to be '\0' terminated
 int coReaderInitByFP(coReader reader, FILE *fp);
+/*
+  map the complete file into the arena "a" (see coArenaMapFile()). The
+  mapping is never modified. The text readers (JSON, A2L) still copy each
+  string into the arena, but with one memcpy instead of one reader call per
+  char. Only the binary reader refers to the mapping: strings and memory
+  blocks of binary files (which include the '\0') are not copied.
+  Returns 0 if the file can not be mapped (gzip, UTF-16, no regular file,
+  mmap not supported), use coReaderInitByFP() in this case.
+*/
+int coReaderInitByMmap(coReader reader, FILE *fp, coArena a);
 void coReaderErr(coReader r, const char *msg);
 
-#define coReaderNext(r) ((r)->next_cb(r))
+#define coReaderNext(r)                                                        \
+  ((r)->ptr < (r)->end ? (void)((r)->curr = *(r)->ptr++) : (r)->next_cb(r))
 #define coReaderCurr(r) ((r)->curr)
 
+/* window access: chars which follow coReaderCurr(r) */
+#define coReaderWindow(r) ((r)->ptr)
+#define coReaderWindowSize(r) ((size_t)((r)->end - (r)->ptr))
+/*
+  skip the current char and the next n-1 chars (n >= 1) and read the next char,
+  n-1 must not exceed coReaderWindowSize(r).
+  coReaderSkip(r, 1) is identical to coReaderNext(r)
+*/
+#define coReaderSkip(r, n) ((r)->ptr += (n) - 1, coReaderNext(r))
+
+/*
+  locale independent and correctly rounded replacement for strtod() (decimal
+  numbers only), used by the JSON reader
+*/
+double coStrToDbl(const char *s, char **end);
+
+/*
+  span scanner: return the number of chars at the beginning of p (max len)
+  which are white space (<= ' ', coScanWhiteSpace), regular string chars
+  (not '"', not '\\' and not below ' ', coScanJSONStr) or unquoted CSV
+  field chars (not '"', separator, '\n' or '\r', coScanCSVField).
+  SSE2/AVX2 is used if available.
+*/
+size_t coScanWhiteSpace(const unsigned char *p, size_t len);
+size_t coScanJSONStr(const unsigned char *p, size_t len);
+size_t coScanCSVField(const unsigned char *p, size_t len, int separator);
+
+/*
+  convert 2*cnt hex digits into cnt bytes and add the bytes to *sum (sum can be
+  NULL). Returns the number of converted bytes (less than cnt for an illegal
+  hex digit). SSE2/AVX2 is used if available.
+*/
+size_t coHexToMem(const char *s, size_t cnt, unsigned char *mem,
+                  unsigned long *sum);
+
+/*
+  select the scanner and coHexToMem() implementation, level 0: scalar, 1: SSE2,
+  2: AVX2 (default if available). Returns the selected level. For tests and
+  benchmarks only, not thread safe.
+*/
+int coSetSIMD(int level);
+
 #define coReaderSkipWhiteSpace(r)                                              \
   for (;;) {                                                                   \
     if (coReaderCurr(r) < 0)                                                   \
       break;                                                                   \
     if (coReaderCurr(r) > ' ')                                                 \
       break;                                                                   \
-    coReaderNext(r);                                                           \
+    coReaderSkip(r, coScanWhiteSpace(coReaderWindow(r),                        \
+                                     coReaderWindowSize(r)) +                  \
+                        1);                                                    \
   }
 
+/* output writer interface
+
+  All output is collected in buf. If buf is full, flush_cb moves the
+  content to the destination: FILE, allocated memory or gzip stream.
+  coWriterClose() must be called at the end.
+*/
+
+#define CO_WRITER_BUF_SIZE (64 * 1024)
+
+typedef int (*coWriterFlushFn)(coWriter w);
+
+struct co_writer_struct {
+  size_t pos; // number of chars in buf
+  int is_error; // write or memory error
+  coWriterFlushFn flush_cb;
+  FILE *fp;
+  char *mem; // memory writer: '\0' terminated output, must be free'd
+  size_t mem_len; // memory writer: strlen(mem)
+  size_t mem_cap;
+#ifdef CO_USE_ZLIB
+  int is_gz;
+  z_stream strm;
+#endif /* CO_USE_ZLIB */
+  char buf[CO_WRITER_BUF_SIZE];
+};
+
+int coWriterInitByFP(coWriter w, FILE *fp);
+int coWriterInitByMem(coWriter w);
+int coWriterInitByPreallocatedMem(coWriter w, char *mem, size_t size); // size includes '\0'
+#ifdef CO_USE_ZLIB
+int coWriterInitByGzFP(coWriter w, FILE *fp, int level); // level: 0..9 or Z_DEFAULT_COMPRESSION, fp==NULL: write to w->mem
+#endif
+void coWriterPutcSlow(coWriter w, int c);
+void coWriterWrite(coWriter w, const char *s, size_t n);
+void coWriterPuts(coWriter w, const char *s);
+void coWriterPutDbl(coWriter w, double d); // shortest representation, see coDblToStr()
+int coWriterFlush(coWriter w);
+int coWriterClose(coWriter w); // returns 0 if an error has happend
+
+#define coWriterPutc(w, c)                                                     \
+  ((w)->pos < CO_WRITER_BUF_SIZE ? (void)((w)->buf[(w)->pos++] = (char)(c))    \
+                                 : coWriterPutcSlow((w), (c)))
+
+/*
+  write the shortest string, which is read back as d (Ryu algorithm),
+  s must have at least 32 bytes, returns strlen(s)
+*/
+int coDblToStr(double d, char *s);
+
 /* functions from co_extra.c */
+
+/*
+  optional argument of the ...WithInfo() parallel readers, can be NULL.
+  chunk_size is set by the caller, the other members are set by the reader.
+*/
+struct co_parallel_info_struct {
+  size_t chunk_size; // min. size of a chunk in bytes, 0: default size (CSV: 64KB, A2L: no min. size)
+  int thread_cnt; // number of threads, which have parsed the chunks, 0 if the serial reader was used
+  long chunk_cnt; // number of chunks
+  long reparse_cnt; // number of chunks, which were parsed again (CSV: line feed inside a quoted field)
+};
+typedef struct co_parallel_info_struct coParallelInfo;
+
 co coReadA2LByString(const char *json);
 co coReadA2LByFP(FILE *fp);
+co coReadA2LByStringWithArena(const char *a2l, coArena a);
+co coReadA2LByFPWithArena(FILE *fp, coArena a); // uses coReaderInitByMmap() if possible, tokens are copied into the arena
+co coReadA2LByStringWithPool(const char *a2l, coArena a, co pool); // pool: coNewHashMap(CO_STRDUP) or coNewStrPool(), a can be NULL
+co coReadA2LByFPWithPool(FILE *fp, coArena a, co pool); // identical tokens share the memory inside the pool
+co coReadA2LByStringParallel(const char *a2l, co pool, int thread_cnt); // parse the MODULE content with thread_cnt threads, pool can be NULL
+co coReadA2LByFPParallel(FILE *fp, co pool, int thread_cnt); // same tree as coReadA2LByFPWithPool(fp, NULL, pool)
+co coReadA2LByFPParallelWithInfo(FILE *fp, co pool, int thread_cnt, coParallelInfo *info); // threads share a coNewStrPool() pool, a hash map pool uses the serial reader
 co coReadS19ByFP(FILE *fp); // returns map, key=8digit addres, value=mem block
 co coReadHEXByFP(FILE *fp); // returns map, key=8digit addres, value=mem block
 co coReadElfMemoryByFP(FILE *fp); // returns map, key=8digit addres, value=mem
                                   // block, .gz is NOT supported
+co coReadS19MemImageByFP(FILE *fp); // returns memory image, see coNewMemImage()
+co coReadHEXMemImageByFP(FILE *fp); // returns memory image
+#define CO_READ_MEM_IMAGE 1 // return a memory image instead of a map
+#define CO_READ_CHECKSUM 2  // verify the checksum of each record, NULL for error
+co coReadS19ByFPWithFlags(FILE *fp, unsigned flags); // flags: CO_READ_MEM_IMAGE, CO_READ_CHECKSUM
+co coReadHEXByFPWithFlags(FILE *fp, unsigned flags); // flags: CO_READ_MEM_IMAGE, CO_READ_CHECKSUM
+co coReadS19ByFPParallel(FILE *fp, int thread_cnt, unsigned flags); // same result as coReadS19ByFPWithFlags()
+co coReadElfMemImageByFP(FILE *fp); // returns memory image, .gz is NOT supported
 co coReadCSVByFP(
     FILE *fp, int separator); // returns vector, separator should be ',' or ';'
 co coReadCSVByFPWithPool(
     FILE *fp, int separator,
     co pool); // same as coReadCSVByFP, but will allocate all strings in the
-              // pool, which must be a map with CO_FREE_VALS flag, pool can be
-              // NULL
+              // pool, which must be a map with CO_FREE_VALS flag or a string
+              // pool (coNewStrPool()), pool can be NULL. A field with '\0'
+              // can not be stored in a map (read error)
 co coGetCSVRow(struct co_reader_struct *r, int separator);
+co coReadCSVByFPParallel(FILE *fp, int separator, co pool, int thread_cnt); // same as coReadCSVByFPWithPool(), pool can be NULL, a string pool is shared by all threads
+co coReadCSVByFPParallelWithInfo(FILE *fp, int separator, co pool, int thread_cnt, coParallelInfo *info);
+
+/*
+  CSV cursor: read a CSV file row by row without creating objects. The row
+  buffer and the field list are reused for all rows, so memory only grows up
+  to the size of the largest row. The fields of the current row are valid
+  until the next call to coCSVCursorNext().
+
+    struct co_csv_cursor_struct c;
+    coCSVCursorInit(&c, &reader, ',');
+    while (coCSVCursorNext(&c) > 0)
+      for (i = 0; i < coCSVCursorCnt(&c); i++)
+        fwrite(coCSVCursorStr(&c, i), 1, coCSVCursorLen(&c, i), stdout);
+    coCSVCursorClose(&c);
+*/
+struct co_csv_field_struct {
+  const char *str; // field inside the row buffer, followed by a '\0'
+  size_t len; // length of the field in bytes, str may contain '\0' (len can be larger than strlen(str))
+  size_t pos; // internal: offset of str inside the row buffer
+};
+
+typedef struct co_csv_cursor_struct *coCSVCursor;
+
+struct co_csv_cursor_struct {
+  coReader reader;
+  int separator;
+  long row_nr; // number of rows read so far
+  struct co_csv_field_struct *field_list;
+  size_t field_cnt;
+  size_t field_max;
+  char *buf; // all fields of the current row
+  size_t buf_size;
+};
+
+int coCSVCursorInit(coCSVCursor c, coReader r, int separator); // returns 0 for memory error
+long coCSVCursorNext(coCSVCursor c); // returns number of fields, 0 at end of file, -1 for memory error
+co coCSVCursorGetRow(coCSVCursor c, co pool); // vector with the fields of the current row, same as coGetCSVRow(), pool can be NULL
+void coCSVCursorClose(coCSVCursor c);
+#define coCSVCursorCnt(c) ((long)(c)->field_cnt)
+#define coCSVCursorStr(c, i) ((c)->field_list[i].str)
+#define coCSVCursorLen(c, i) ((c)->field_list[i].len)
+
+/*
+  read a CSV file into a table object (see coNewTable()).
+  schema: comma separated list of the columns, which should be loaded, e.g.
+    "speed:dbl,count:int,name". The column is either a name from the header
+    line (CO_CSV_HEADER) or the column number (0 for the first column). The
+    type is one of "int", "dbl", "str" or "auto" (default). Only the
+    listed columns are converted and stored, in the order of the schema.
+  schema == NULL: load all columns of the first row as "auto" columns.
+  The rows and fields are the same as for coReadCSVByFP().
+*/
+#define CO_CSV_HEADER 1 // the first row contains the column names
+co coReadCSVTableByFP(FILE *fp, int separator, const char *schema, unsigned flags); // returns NULL for memory error or unknown column
 
 /* co_xml.c */
 co coReadXMLByFP(FILE *fp, int skip_white_space);
@@ -16,9 +16,11 @@
 #include <fcntl.h>
 #include <gelf.h>
 #include <libelf.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 /*===================================================================*/
@@ -76,8 +78,22 @@ const char *coA2LGetString(coReader reader, char *buf) {
       } // treat escaped char as it is (this will handle both slashes) ...
     } // escape
     else {
-      coReaderNext(reader);
-      buf[idx++] = c; // handle normal char
+      // handle normal char together with all normal chars from the reader
+      // window, which still fit into buf
+      const unsigned char *p = coReaderWindow(reader);
+      const unsigned char *e = p + coReaderWindowSize(reader);
+      size_t n;
+      if (idx + 16 >= CO_A2L_IDENTIFIER_STRING_MAX)
+        e = p;
+      else if ((size_t)(e - p) > CO_A2L_IDENTIFIER_STRING_MAX - 16 - idx)
+        e = p + (CO_A2L_IDENTIFIER_STRING_MAX - 16 - idx);
+      while (p < e && *p != '\"' && *p != '\\')
+        p++;
+      n = p - coReaderWindow(reader);
+      buf[idx++] = c;
+      memcpy(buf + idx, coReaderWindow(reader), n);
+      idx += n;
+      coReaderSkip(reader, n + 1);
     }
     if (idx + 8 >=
         CO_A2L_IDENTIFIER_STRING_MAX) // check whether the buffer is full
@@ -93,6 +109,9 @@ const char *coA2LGetString(coReader reader, char *buf) {
 const char *coA2LGetIdentifier(coReader reader, int prefix, char *buf) {
   int c;
   size_t idx = 0;
+  const unsigned char *p;
+  const unsigned char *e;
+  size_t n;
   if (prefix >= 0) // this is used by the '/' detection procedure below
     buf[idx++] = prefix;
   for (;;) {
@@ -105,8 +124,18 @@ const char *coA2LGetIdentifier(coReader reader, int prefix, char *buf) {
       break; // string start
     if (idx + 2 >= CO_A2L_IDENTIFIER_STRING_MAX)
       return coReaderErr(reader, "Identifier too long"), NULL;
+    // copy c and all following identifier chars from the reader window
+    p = coReaderWindow(reader);
+    e = p + coReaderWindowSize(reader);
+    if ((size_t)(e - p) > CO_A2L_IDENTIFIER_STRING_MAX - 3 - idx)
+      e = p + (CO_A2L_IDENTIFIER_STRING_MAX - 3 - idx);
+    while (p < e && *p > ' ' && *p != '/' && *p != '\"')
+      p++;
+    n = p - coReaderWindow(reader);
     buf[idx++] = c;
-    coReaderNext(reader);
+    memcpy(buf + idx, coReaderWindow(reader), n);
+    idx += n;
+    coReaderSkip(reader, n + 1);
   }
   buf[idx] = '\0';
   coReaderSkipWhiteSpace(reader);
@@ -188,7 +217,9 @@ co coA2LGetArray(coReader reader, char *buf, int depth) {
   static char if_data[] = "IF_DATA";
   static char measurement[] = "MEASUREMENT";
 
-  array_obj = coNewVector(CO_FREE_VALS);
+  array_obj = coNewVectorWithArena(reader->arena, CO_FREE_VALS);
+  if (array_obj == NULL)
+    return coReaderErr(reader, "Memory error with array create"), NULL;
   for (;;) {
     t = coA2LGetToken(reader, buf);
     // printf("%2d %p %s\n", depth, array_obj, t);
@@ -200,8 +231,8 @@ co coA2LGetArray(coReader reader, char *buf, int depth) {
       return coDelete(array_obj), NULL;
     } else if (strcmp(t, "/begin") == 0) {
       element = coA2LGetArray(reader, buf, depth + 1);
-      if (element == NULL)
-        return NULL;
+      if (element == NULL) // error is already reported
+        return coDelete(array_obj), NULL;
       if (coVectorAdd(array_obj, element) < 0)
         return coReaderErr(reader, "Memory error inside 'array'"),
                coDelete(array_obj), NULL;
@@ -209,33 +240,57 @@ co coA2LGetArray(coReader reader, char *buf, int depth) {
       coA2LGetToken(reader, buf); // read next token. this should be the same as
                                   // the /begin argument
       break;
+    } else if (coIsStrPool(reader->pool)) {
+      // the string object of the pool is shared by all equal tokens
+      element = (co)coStrPoolAdd(reader->pool, t, strlen(t));
+      if (element == NULL)
+        return coReaderErr(reader, "Memory error inside 'pool'"),
+               coDelete(array_obj), NULL;
+      if (coVectorAdd(array_obj, element) < 0)
+        return coReaderErr(reader, "Memory error inside 'array'"),
+               coDelete(array_obj), NULL;
+    } else if (reader->pool != NULL) {
+      // use the interned copy of the token, all string objects with the same
+      // token share the same memory
+      const char *k = coHashMapAdd(reader->pool, t, NULL);
+      if (k == NULL)
+        return coReaderErr(reader, "Memory error inside 'pool'"),
+               coDelete(array_obj), NULL;
+      element = coNewStrWithArena(reader->arena, CO_NONE, k);
+      if (element == NULL)
+        return coReaderErr(reader, "Memory error inside 'array'"),
+               coDelete(array_obj), NULL;
+      if (coVectorAdd(array_obj, element) < 0)
+        return coReaderErr(reader, "Memory error inside 'array'"),
+               coDelete(array_obj), NULL;
     } else {
       if (t[0] == '0' || t[0] == '1' || t[0] == 'I' || t[0] == 'M') {
         // do a little bit of speed improvment, by avoiding the allocation of
         // some very common strings
         if (strcmp(t, zero) == 0)
-          element =
-              coNewStr(CO_NONE, zero); // use a static string to avoid malloc
+          element = coNewStrWithArena(
+              reader->arena, CO_NONE, zero); // use a static string to avoid malloc
         else if (strcmp(t, one) == 0)
-          element =
-              coNewStr(CO_NONE, one); // use a static string to avoid malloc
+          element = coNewStrWithArena(
+              reader->arena, CO_NONE, one); // use a static string to avoid malloc
         else if (strcmp(t, if_data) == 0)
-          element =
-              coNewStr(CO_NONE, if_data); // use a static string to avoid malloc
+          element = coNewStrWithArena(
+              reader->arena, CO_NONE, if_data); // use a static string to avoid malloc
         else if (strcmp(t, measurement) == 0)
-          element = coNewStr(
-              CO_NONE, measurement); // use a static string to avoid malloc
+          element = coNewStrWithArena(
+              reader->arena, CO_NONE, measurement); // use a static string to avoid malloc
         else
-          element = coNewStr(
-              CO_STRDUP,
-              t); // t is a pointer into constant memory, so do a strdup
+          element = coNewStrWithArena(
+              reader->arena, t == buf ? CO_STRDUP : CO_NONE,
+              t); // t is a pointer into buf (strdup required)
       } else {
-        element =
-            coNewStr(CO_STRDUP,
-                     t); // t is a pointer into constant memory, so do a strdup
+        element = coNewStrWithArena(
+            reader->arena, t == buf ? CO_STRDUP : CO_NONE,
+            t); // t is a pointer into buf (strdup required)
       }
       if (element == NULL)
-        return NULL;
+        return coReaderErr(reader, "Memory error inside 'array'"),
+               coDelete(array_obj), NULL;
       if (coVectorAdd(array_obj, element) < 0)
         return coReaderErr(reader, "Memory error inside 'array'"),
                coDelete(array_obj), NULL;
@@ -266,6 +321,366 @@ co coReadA2LByFP(FILE *fp) {
   return coA2LGetArray(&reader, buf, 0);
 }
 
+/* all objects are created inside the arena "a", the result must not be
+ * deleted, instead use coDeleteArena() */
+co coReadA2LByStringWithArena(const char *a2l, coArena a) {
+  return coReadA2LByStringWithPool(a2l, a, NULL);
+}
+
+co coReadA2LByFPWithArena(FILE *fp, coArena a) {
+  return coReadA2LByFPWithPool(fp, a, NULL);
+}
+
+/*
+  all tokens are interned in "pool", which must be a hash map with CO_STRDUP
+  (coNewHashMap(CO_STRDUP)) or a string pool (coNewStrPool()). The string
+  objects of the result refer to the keys of the pool (or are the string
+  objects of the string pool), so the pool must be deleted after the result.
+  The pool can be used for several A2L files. a and pool can be NULL.
+*/
+co coReadA2LByStringWithPool(const char *a2l, coArena a, co pool) {
+  struct co_reader_struct reader;
+  char buf[CO_A2L_IDENTIFIER_STRING_MAX];
+
+  if (coReaderInitByString(&reader, a2l) == 0)
+    return NULL;
+  reader.arena = a;
+  reader.pool = pool;
+  return coA2LGetArray(&reader, buf, 0);
+}
+
+co coReadA2LByFPWithPool(FILE *fp, coArena a, co pool) {
+  struct co_reader_struct reader;
+  char buf[CO_A2L_IDENTIFIER_STRING_MAX];
+
+  if (coReaderInitByMmap(&reader, fp, a) == 0) {
+    if (coReaderInitByFP(&reader, fp) == 0)
+      return NULL;
+    reader.arena = a;
+  }
+  reader.pool = pool;
+  return coA2LGetArray(&reader, buf, 0);
+}
+
+/*===================================================================*/
+/* Parallel A2L Parser */
+/*===================================================================*/
+
+/*
+  The content of the first "/begin MODULE" block inside "/begin PROJECT"
+  is split into chunks. Each chunk contains complete child blocks of the
+  MODULE. The chunks are parsed in parallel and the results are moved into
+  the MODULE vector, which is created from the remaining A2L text (everything
+  before and after the MODULE content).
+  The resulting tree is identical to the result of coReadA2LByFP().
+*/
+
+#define CO_A2L_THREAD_MAX 64
+#define CO_A2L_CHUNKS_PER_THREAD 4
+
+struct co_a2l_chunk_struct {
+  const char *start;
+  const char *end;
+  co result;
+};
+
+struct co_a2l_job_struct {
+  struct co_a2l_chunk_struct *chunk_list;
+  long chunk_cnt;
+  co pool; // string pool or NULL, coStrPoolAdd() is used by all threads
+  long next; // next chunk to parse, protected by mutex
+  pthread_mutex_t mutex;
+};
+
+/* skip white space and comments */
+static const char *coA2LScanSpace(const char *p, const char *e) {
+  for (;;) {
+    while (p < e && *(const unsigned char *)p <= ' ')
+      p++;
+    if (p + 1 >= e || p[0] != '/')
+      return p;
+    if (p[1] == '/') { // line comment
+      p += 2;
+      while (p < e && *p != '\n' && *p != '\r')
+        p++;
+    } else if (p[1] == '*') { // block comment
+      p += 2;
+      while (p + 1 < e && (p[0] != '*' || p[1] != '/'))
+        p++;
+      p = p + 1 < e ? p + 2 : e;
+    } else
+      return p;
+  }
+}
+
+/* return the end of the token at p, returns NULL for an incomplete string */
+static const char *coA2LScanToken(const char *p, const char *e) {
+  if (*p == '\"') {
+    p++;
+    while (p < e && *p != '\"') {
+      if (*p == '\\')
+        p++;
+      p++;
+    }
+    if (p >= e)
+      return NULL;
+    return p + 1;
+  }
+  if (*p == '/')
+    p++;
+  while (p < e && *(const unsigned char *)p > ' ' && *p != '/' && *p != '\"')
+    p++;
+  return p;
+}
+
+#define coA2LIsToken(t, n, s) ((n) == sizeof(s) - 1 && memcmp((t), (s), (n)) == 0)
+
+/*
+  find the MODULE content and split it into max chunk_max chunks with at
+  least chunk_min bytes
+  returns the number of chunks, 0 if the split is not possible
+  *module_start: first char after the MODULE keyword
+  *module_end: start of the "/end MODULE" token
+*/
+static long coA2LSplit(const char *s, const char *e, long chunk_max,
+                       size_t chunk_min,
+                       struct co_a2l_chunk_struct *chunk_list,
+                       const char **module_start, const char **module_end) {
+  const char *p = s;
+  const char *t;
+  const char *end_token = NULL; // start of the last "/end" token
+  size_t target = (size_t)(e - s) / chunk_max + 1; // chunk size
+  int depth = 0;
+  int is_begin = 0; // previous token was "/begin"
+  int is_end = 0; // previous token was "/end"
+  long cnt = 0;
+
+  if (target < chunk_min)
+    target = chunk_min;
+  *module_start = NULL;
+  *module_end = NULL;
+  for (;;) {
+    p = coA2LScanSpace(p, e);
+    if (p >= e)
+      return 0; // no MODULE or no MODULE end found
+    t = p;
+    p = coA2LScanToken(p, e);
+    if (p == NULL)
+      return 0;
+    if (is_begin) {
+      is_begin = 0;
+      if (*module_start == NULL && depth == 2 &&
+          coA2LIsToken(t, p - t, "MODULE")) {
+        *module_start = p;
+        chunk_list[0].start = p;
+      }
+    } else if (is_end) {
+      is_end = 0;
+      if (*module_start != NULL) {
+        if (depth < 2) { // end of the MODULE block
+          *module_end = end_token;
+          chunk_list[cnt].end = p; // the last chunk includes "/end MODULE"
+          return cnt + 1;
+        }
+        if (depth == 2 && p - chunk_list[cnt].start >= (long)target &&
+            cnt + 2 < chunk_max) {
+          chunk_list[cnt].end = p; // end of a child block of MODULE
+          cnt++;
+          chunk_list[cnt].start = p;
+        }
+      }
+    } else if (coA2LIsToken(t, p - t, "/begin")) {
+      depth++;
+      is_begin = 1;
+    } else if (coA2LIsToken(t, p - t, "/end")) {
+      depth--;
+      is_end = 1;
+      end_token = t;
+    }
+  }
+}
+
+static void *coA2LParseThread(void *data) {
+  struct co_a2l_job_struct *job = (struct co_a2l_job_struct *)data;
+  struct co_reader_struct reader;
+  char buf[CO_A2L_IDENTIFIER_STRING_MAX];
+  struct co_a2l_chunk_struct *chunk;
+  long i;
+
+  for (;;) {
+    pthread_mutex_lock(&(job->mutex));
+    i = job->next++;
+    pthread_mutex_unlock(&(job->mutex));
+    if (i >= job->chunk_cnt)
+      break;
+    chunk = job->chunk_list + i;
+    if (coReaderInitByMem(&reader, chunk->start, chunk->end - chunk->start)) {
+      reader.pool = job->pool;
+      chunk->result = coA2LGetArray(&reader, buf, 1);
+    }
+  }
+  return NULL;
+}
+
+/* return the first vector at depth 2, which starts with "MODULE" */
+static co coA2LFindModule(co a2l) {
+  long i, j;
+  co project;
+  co module;
+  for (i = 0; i < coVectorSize(a2l); i++) {
+    project = (co)coVectorGet(a2l, i);
+    if (!coIsVector(project))
+      continue;
+    for (j = 0; j < coVectorSize(project); j++) {
+      module = (co)coVectorGet(project, j);
+      if (coIsVector(module) && coVectorSize(module) > 0 &&
+          coIsStr(coVectorGet(module, 0)) &&
+          strcmp(coStrGet(coVectorGet(module, 0)), "MODULE") == 0)
+        return module;
+    }
+  }
+  return NULL;
+}
+
+/*
+  parse the A2L data [s, e) with thread_cnt threads, pool must be NULL or a
+  string pool, info can be NULL
+  returns NULL if the parallel read is not possible or for any parse error
+*/
+static co coA2LReadParallel(const char *s, const char *e, co pool,
+                            int thread_cnt, coParallelInfo *info) {
+  struct co_a2l_job_struct job;
+  struct co_reader_struct reader;
+  char buf[CO_A2L_IDENTIFIER_STRING_MAX];
+  pthread_t thread_list[CO_A2L_THREAD_MAX];
+  const char *module_start, *module_end;
+  char *outer; // A2L text without the MODULE content
+  size_t outer_len;
+  co a2l = NULL;
+  co module;
+  long i;
+  int ok = 1;
+
+  if (thread_cnt > CO_A2L_THREAD_MAX)
+    thread_cnt = CO_A2L_THREAD_MAX;
+  job.chunk_list = (struct co_a2l_chunk_struct *)malloc(
+      sizeof(struct co_a2l_chunk_struct) * thread_cnt *
+      CO_A2L_CHUNKS_PER_THREAD);
+  if (job.chunk_list == NULL)
+    return NULL;
+  job.chunk_cnt = coA2LSplit(s, e, thread_cnt * CO_A2L_CHUNKS_PER_THREAD,
+                             info == NULL ? 0 : info->chunk_size,
+                             job.chunk_list, &module_start, &module_end);
+  if (job.chunk_cnt < 2)
+    return free(job.chunk_list), NULL;
+  for (i = 0; i < job.chunk_cnt; i++)
+    job.chunk_list[i].result = NULL;
+
+  job.pool = pool;
+  job.next = 0;
+  pthread_mutex_init(&(job.mutex), NULL);
+  for (i = 0; i < thread_cnt; i++)
+    if (pthread_create(thread_list + i, NULL, coA2LParseThread, &job) != 0)
+      break;
+  thread_cnt = i; // number of started threads
+
+  // meanwhile parse the A2L text without the MODULE content
+  outer_len = (module_start - s) + 1 + (e - module_end);
+  outer = (char *)malloc(outer_len);
+  if (outer != NULL) {
+    memcpy(outer, s, module_start - s);
+    outer[module_start - s] = '\n';
+    memcpy(outer + (module_start - s) + 1, module_end, e - module_end);
+    if (coReaderInitByMem(&reader, outer, outer_len)) {
+      reader.pool = pool;
+      a2l = coA2LGetArray(&reader, buf, 0);
+    }
+    free(outer);
+  }
+
+  if (thread_cnt == 0) // no thread was started
+    coA2LParseThread(&job);
+  for (i = 0; i < thread_cnt; i++)
+    pthread_join(thread_list[i], NULL);
+  pthread_mutex_destroy(&(job.mutex));
+
+  module = a2l == NULL ? NULL : coA2LFindModule(a2l);
+  if (module == NULL)
+    ok = 0;
+  for (i = 0; i < job.chunk_cnt; i++) {
+    if (job.chunk_list[i].result == NULL)
+      ok = 0;
+    else if (ok)
+      ok = coVectorMoveVector(module, job.chunk_list[i].result);
+    coDelete(job.chunk_list[i].result);
+  }
+  if (ok && info != NULL) {
+    info->thread_cnt = thread_cnt == 0 ? 1 : thread_cnt;
+    info->chunk_cnt = job.chunk_cnt;
+  }
+  free(job.chunk_list);
+  if (ok == 0)
+    return coDelete(a2l), NULL;
+  return a2l;
+}
+
+/*
+  same as coReadA2LByStringWithPool() without arena, but parse the MODULE
+  content with thread_cnt threads. A string pool (coNewStrPool()) is shared by
+  all threads. A hash map pool is not thread safe, the serial reader is used
+  in this case.
+*/
+co coReadA2LByStringParallel(const char *a2l, co pool, int thread_cnt) {
+  co o;
+  if (thread_cnt > 1 && (pool == NULL || coIsStrPool(pool))) {
+    o = coA2LReadParallel(a2l, a2l + strlen(a2l), pool, thread_cnt, NULL);
+    if (o != NULL)
+      return o;
+  }
+  if (pool == NULL)
+    return coReadA2LByString(a2l);
+  return coReadA2LByStringWithPool(a2l, NULL, pool);
+}
+
+/*
+  same as coReadA2LByFPWithPool() without arena, but parse the MODULE content
+  with thread_cnt threads. The file is mapped into memory, gzip and UTF-16
+  files and a hash map pool use the serial reader. info can be NULL,
+  info->thread_cnt is 0 if the serial reader was used.
+*/
+co coReadA2LByFPParallelWithInfo(FILE *fp, co pool, int thread_cnt,
+                                 coParallelInfo *info) {
+  struct co_reader_struct reader;
+  coArena a;
+  co o = NULL;
+  if (info != NULL) {
+    info->thread_cnt = 0;
+    info->chunk_cnt = 0;
+    info->reparse_cnt = 0;
+  }
+  if (thread_cnt > 1 && (pool == NULL || coIsStrPool(pool))) {
+    a = coNewArena(0); // owner of the file mapping
+    if (a == NULL)
+      return NULL;
+    if (coReaderInitByMmap(&reader, fp, a))
+      o = coA2LReadParallel((const char *)coReaderWindow(&reader) - 1,
+                            (const char *)coReaderWindow(&reader) +
+                                coReaderWindowSize(&reader),
+                            pool, thread_cnt, info);
+    coDeleteArena(a);
+    if (o != NULL)
+      return o;
+    fseek(fp, 0, SEEK_SET);
+  }
+  if (pool == NULL)
+    return coReadA2LByFP(fp);
+  return coReadA2LByFPWithPool(fp, NULL, pool);
+}
+
+co coReadA2LByFPParallel(FILE *fp, co pool, int thread_cnt) {
+  return coReadA2LByFPParallelWithInfo(fp, pool, thread_cnt, NULL);
+}
+
 /*===================================================================*/
 /* S19 Reader */
 /*===================================================================*/
@@ -286,63 +701,241 @@ static unsigned hexToUnsigned(const char *s) {
   return n;
 }
 
-static void hexToMem(const char *s, size_t cnt, unsigned char *mem) {
+/* convert cnt bytes, the sum of all bytes is added to *sum (checksum) */
+static void hexToMem(const char *s, size_t cnt, unsigned char *mem,
+                     unsigned long *sum) {
+  size_t n = coHexToMem(s, cnt, mem, sum); // SIMD conversion
+  // illegal hex digits are converted as before
+  s += 2 * n;
+  mem += n;
+  cnt -= n;
   while (cnt > 0) {
-    *mem++ = hexToUnsigned(s);
+    *mem = hexToUnsigned(s);
+    *sum += *mem++;
     s += 2;
     cnt--;
   }
 }
 
-co coReadS19ByFP(FILE *fp) {
+/*
+  copy the next line without the end of line ('\n', eol2 or "\r\n") into buf.
+  Complete lines are copied from the reader window with memcpy().
+  returns the length of the line, -1 at the end of the input or -2 if the
+  line doesn't fit into buf
+*/
+static long coReaderGetLine(coReader r, char *buf, size_t size, int eol2) {
+  const unsigned char *p, *e;
+  size_t i = 0;
+  size_t n;
+  int c = coReaderCurr(r);
+  if (c < 0)
+    return -1;
+  for (;;) {
+    if (c < 0) // last line without end of line char
+      break;
+    if (c == '\n' || c == eol2) {
+      coReaderNext(r);
+      if (c == '\r' && coReaderCurr(r) == '\n')
+        coReaderNext(r); // "\r\n" is one end of line
+      break;
+    }
+    // find the end of the line inside the window
+    p = coReaderWindow(r);
+    e = p + coReaderWindowSize(r);
+    while (p < e && *p != '\n' && *p != eol2)
+      p++;
+    n = p - coReaderWindow(r);
+    if (i + 1 + n >= size)
+      return -2;
+    buf[i++] = c;
+    memcpy(buf + i, coReaderWindow(r), n);
+    i += n;
+    coReaderSkip(r, n + 1); // curr is now the end of line char or the first
+                            // char of the next window
+    c = coReaderCurr(r);
+  }
+  buf[i] = '\0';
+  return (long)i;
+}
+
+/*
+  Target of the S19, HEX and ELF readers: Either a map (key=8 digit address,
+  value=mem block), a memory image (coNewMemImage()) or a run list (coNewMem()),
+  which is used by the parallel S19 reader: All data is appended to the
+  memory block, a new run is started if the address does not continue the
+  previous run.
+*/
+struct co_mem_run_struct {
+  size_t address;
+  size_t len;
+  size_t offset; // position of the data inside the memory block
+};
+
+struct co_mem_target_struct {
+  co o;              // map, memory image or memory block
+  co mo;             // last memory block of the map
+  size_t last_address; // end address of the last block
+  size_t reserve;    // estimated number of data bytes, which are not reserved
+  struct co_mem_run_struct *run_list; // only used for memory block
+  size_t run_cnt;
+  size_t run_max;
+};
+
+/*
+  bytes_per_data_byte: estimation of the file size per data byte, the number
+  of data bytes is reserved with the first memory block. 0: no reservation
+*/
+static void coMemTargetInit(struct co_mem_target_struct *t, co o, FILE *fp,
+                            size_t bytes_per_data_byte) {
+  struct stat st;
+  t->o = o;
+  t->mo = NULL;
+  t->last_address = 0xffffffff;
+  t->reserve = 0;
+  t->run_list = NULL;
+  t->run_cnt = 0;
+  t->run_max = 0;
+  // the size of a compressed file is too low, but still a good start
+  if (bytes_per_data_byte > 0 && fstat(fileno(fp), &st) == 0 &&
+      S_ISREG(st.st_mode) && st.st_size > 0)
+    t->reserve = (size_t)st.st_size / bytes_per_data_byte;
+}
+
+/*
+  Reserve the remaining estimated size for the block, which has been started
+  at address, so that a large image is not copied during the load.
+  Unused memory is released by coMemTargetFinish()
+*/
+static int coMemTargetReserve(struct co_mem_target_struct *t, size_t address,
+                              size_t mem_cnt) {
+  size_t reserve = t->reserve;
+  t->reserve = 0; // reserve only once, later blocks grow as usual
+  if (reserve <= mem_cnt)
+    return 1;
+  if (coIsMemImage(t->o))
+    return coMemImageReserve(t->o, address, reserve);
+  if (coIsMem(t->o))
+    return coMemReserve(t->o, reserve);
+  return coMemReserve(t->mo, reserve);
+}
+
+/* append the data to the memory block of a run list, returns 0 for memory
+ * error */
+static int coMemTargetAddRun(struct co_mem_target_struct *t, size_t address,
+                             const unsigned char *mem, size_t mem_cnt,
+                             int is_new_block) {
+  struct co_mem_run_struct *run;
+  if (is_new_block || t->run_cnt == 0) {
+    if (t->run_cnt >= t->run_max) {
+      size_t max = t->run_max < 16 ? 16 : t->run_max * 2;
+      run = (struct co_mem_run_struct *)realloc(
+          t->run_list, max * sizeof(struct co_mem_run_struct));
+      if (run == NULL)
+        return 0;
+      t->run_list = run;
+      t->run_max = max;
+    }
+    run = t->run_list + t->run_cnt++;
+    run->address = address;
+    run->len = 0;
+    run->offset = (size_t)coMemSize(t->o);
+  }
+  if (coMemAdd(t->o, mem, mem_cnt) == 0)
+    return 0;
+  t->run_list[t->run_cnt - 1].len += mem_cnt;
+  return 1;
+}
+
+/* returns 0 for memory error */
+static int coMemTargetAdd(struct co_mem_target_struct *t, size_t address,
+                          const unsigned char *mem, size_t mem_cnt) {
+  char addr_as_hex[24]; // avoid compiler warning regarding sprintf buffer
+                        // overflow
+  int is_new_block = t->last_address != address;
+  if (coIsMemImage(t->o)) {
+    if (coMemImageAdd(t->o, address, mem, mem_cnt) == 0)
+      return 0;
+  } else if (coIsMem(t->o)) {
+    if (coMemTargetAddRun(t, address, mem, mem_cnt, is_new_block) == 0)
+      return 0;
+  } else if (t->mo == NULL || is_new_block) {
+    if (t->mo != NULL && coMemShrink(t->mo) == 0)
+      return 0;
+    sprintf(addr_as_hex, "%08zX", address);
+    t->mo = coNewMem(); // create a new memory block
+    if (t->mo == NULL)
+      return 0;
+    if (coMemAdd(t->mo, mem, mem_cnt) == 0)
+      return coDelete(t->mo), 0;
+    if (coMapAdd(t->o, addr_as_hex, t->mo) == 0)
+      return coDelete(t->mo), 0;
+  } else {
+    if (coMemAdd(t->mo, mem, mem_cnt) == 0) // extend the existing memory block
+      return 0;
+  }
+  if (is_new_block && t->reserve > 0 && mem_cnt > 0)
+    if (coMemTargetReserve(t, address, mem_cnt) == 0)
+      return 0;
+  t->last_address = address + mem_cnt;
+  return 1;
+}
+
+/* release the reserved, but unused memory, returns 0 for memory error */
+static int coMemTargetFinish(struct co_mem_target_struct *t) {
+  if (coIsMemImage(t->o))
+    return coMemImageShrink(t->o);
+  if (coIsMem(t->o))
+    return 1; // the run list is copied by coMemTargetAddRunList()
+  if (t->mo != NULL)
+    return coMemShrink(t->mo);
+  return 1;
+}
+
+/* add all runs of the run list src to t, returns 0 for memory error */
+static int coMemTargetAddRunList(struct co_mem_target_struct *t,
+                                 const struct co_mem_target_struct *src) {
+  const unsigned char *data = (const unsigned char *)coMemGet(src->o);
+  size_t i;
+  for (i = 0; i < src->run_cnt; i++)
+    if (coMemTargetAdd(t, src->run_list[i].address,
+                       data == NULL ? NULL : data + src->run_list[i].offset,
+                       src->run_list[i].len) == 0)
+      return 0;
+  return 1;
+}
+
+#define CO_S19_OK 1
+#define CO_S19_MEMORY_ERROR 0
+#define CO_S19_LINE_LEN_ERROR -1
+#define CO_S19_BYTE_CNT_ERROR -2
+#define CO_S19_CHECKSUM_ERROR -3
+
+/*
+  read all S19 lines from r into the target t. *line_nr is incremented for
+  each line, so it contains the number of the failed line in case of an error.
+  flags: CO_READ_CHECKSUM
+  returns CO_S19_OK or one of the error codes
+*/
+static int coS19ReadLines(coReader r, struct co_mem_target_struct *t,
+                          unsigned flags, long *line_nr) {
   char buf[S19_MAX_LINE_LEN];
   unsigned char mem[S19_MAX_LINE_LEN / 2];
-  char addr_as_hex[20]; // avoid compiler warning regarding sprintf buffer
-                        // overflow
   char *line;
-  size_t last_address = 0xffffffff;
   size_t address;
   size_t byte_cnt;
   size_t mem_cnt;
   int rec_type;
-  int i, c;
-  struct co_reader_struct reader_struct;
-  coReader r = &reader_struct;
-  coReaderInitByFP(r, fp);
+  long len;
+  unsigned long sum; // sum of all record bytes, including the checksum
 
-  co mo = NULL; // memory object
-  co map = coNewMap(CO_FREE_VALS | CO_STRDUP);
-  if (map == NULL)
-    return NULL;
   for (;;) {
-    i = 0;
-    for (;;) {
-      // c = getc(fp);
-      c = coReaderCurr(r);
-      coReaderNext(r);
-      if (c < 0) {
-        if (i == 0)
-          line = NULL;
-        else {
-          line = buf;
-          buf[i] = '\0';
-        }
-        break;
-      }
-
-      if (c == '\n') {
-        line = buf;
-        buf[i] = '\0';
-        break;
-      }
-      if (i >= S19_MAX_LINE_LEN)
-        return puts("illegal line length in s19 file"), coDelete(map), NULL;
-      buf[i++] = c;
-    }
-
-    // line = fgets(buf, S19_MAX_LINE_LEN, fp);
-    if (line == NULL)
+    len = coReaderGetLine(r, buf, S19_MAX_LINE_LEN, '\n');
+    if (len == -2)
+      return CO_S19_LINE_LEN_ERROR;
+    if (len < 0)
       break;
+    line = buf;
+    (*line_nr)++;
 
     while (*line != 'S' && *line != '\0')
       line++;
@@ -351,49 +944,290 @@ co coReadS19ByFP(FILE *fp) {
     if (rec_type >= '1' && rec_type <= '9') {
       byte_cnt = hexToUnsigned(line + 2);
       if (byte_cnt > 255)
-        return puts("wrong byte_cnt"), coDelete(map), NULL;
+        return CO_S19_BYTE_CNT_ERROR;
 
       if (rec_type >= '1' && rec_type <= '3') {
         address = (size_t)hexToUnsigned(line + 4);
+        sum = byte_cnt + address;
         address <<= 8;
         address += (size_t)hexToUnsigned(line + 6);
+        sum += address & 0xff;
         mem_cnt = 0;
         if (rec_type == '1' && byte_cnt >= 3) {
-          hexToMem(line + 8, byte_cnt - 2,
-                   mem); // do not read address, but include checksum
+          hexToMem(line + 8, byte_cnt - 2, mem,
+                   &sum); // do not read address, but include checksum
           mem_cnt = byte_cnt - 3;
         } else if (rec_type == '2' && byte_cnt >= 4) {
           address <<= 8;
           address += (size_t)hexToUnsigned(line + 8);
-          hexToMem(line + 10, byte_cnt - 3,
-                   mem); // do not read address, but include checksum
+          sum += address & 0xff;
+          hexToMem(line + 10, byte_cnt - 3, mem,
+                   &sum); // do not read address, but include checksum
           mem_cnt = byte_cnt - 4;
         } else if (rec_type == '3' && byte_cnt >= 5) {
           address <<= 8;
           address += (size_t)hexToUnsigned(line + 8);
+          sum += address & 0xff;
           address <<= 8;
           address += (size_t)hexToUnsigned(line + 10);
-          hexToMem(line + 12, byte_cnt - 4,
-                   mem); // do not read address, but include checksum
+          sum += address & 0xff;
+          hexToMem(line + 12, byte_cnt - 4, mem,
+                   &sum); // do not read address, but include checksum
           mem_cnt = byte_cnt - 5;
         }
-        sprintf(addr_as_hex, "%08zX", address);
-        if (mo == NULL || last_address != address) {
-          mo = coNewMem(); // create a new memory block
-          if (coMemAdd(mo, mem, mem_cnt) == 0)
-            return coDelete(map), NULL;
-          if (coMapAdd(map, addr_as_hex, mo) == 0)
-            return coDelete(map), NULL;
-        } else {
-          if (coMemAdd(mo, mem, mem_cnt) ==
-              0) // extend the existing memory block
-            return coDelete(map), NULL;
-        }
-        last_address = address + mem_cnt;
+        // the ones' complement checksum: sum of all bytes is 0xff
+        if ((flags & CO_READ_CHECKSUM) && (sum & 0xff) != 0xff)
+          return CO_S19_CHECKSUM_ERROR;
+        if (coMemTargetAdd(t, address, mem, mem_cnt) == 0)
+          return CO_S19_MEMORY_ERROR;
       }
     }
   }
-  return map;
+  return CO_S19_OK;
+}
+
+/* print the error message of coS19ReadLines(), always returns NULL */
+static co coS19Error(int result, long line_nr) {
+  if (result == CO_S19_LINE_LEN_ERROR)
+    puts("illegal line length in s19 file");
+  else if (result == CO_S19_BYTE_CNT_ERROR)
+    puts("wrong byte_cnt");
+  else if (result == CO_S19_CHECKSUM_ERROR)
+    printf("checksum error in s19 file, line %ld\n", line_nr);
+  return NULL;
+}
+
+/*
+  reads the S19 file into o (map or memory image), o is deleted on error.
+  flags: CO_READ_CHECKSUM
+*/
+static co coReadS19ToObject(FILE *fp, co o, unsigned flags) {
+  long line_nr = 0;
+  int result;
+  struct co_reader_struct reader_struct;
+  struct co_mem_target_struct target;
+  coReader r = &reader_struct;
+  coReaderInitByFP(r, fp);
+
+  if (o == NULL)
+    return NULL;
+  coMemTargetInit(&target, o, fp, 2); // two hex digits per data byte
+  result = coS19ReadLines(r, &target, flags, &line_nr);
+  if (result == CO_S19_OK && coMemTargetFinish(&target) == 0)
+    result = CO_S19_MEMORY_ERROR;
+  if (result != CO_S19_OK)
+    return coDelete(o), coS19Error(result, line_nr);
+  return o;
+}
+
+co coReadS19ByFP(FILE *fp) {
+  return coReadS19ToObject(fp, coNewMap(CO_FREE_VALS | CO_STRDUP), CO_NONE);
+}
+
+co coReadS19MemImageByFP(FILE *fp) {
+  return coReadS19ToObject(fp, coNewMemImage(), CO_NONE);
+}
+
+/* flags: CO_READ_MEM_IMAGE, CO_READ_CHECKSUM */
+co coReadS19ByFPWithFlags(FILE *fp, unsigned flags) {
+  if (flags & CO_READ_MEM_IMAGE)
+    return coReadS19ToObject(fp, coNewMemImage(), flags);
+  return coReadS19ToObject(fp, coNewMap(CO_FREE_VALS | CO_STRDUP), flags);
+}
+
+/*===================================================================*/
+/* Parallel S19 Reader */
+/*===================================================================*/
+
+/*
+  The S19 file is mapped into memory and split at line boundaries into
+  chunks. Each chunk is decoded into a run list (a memory block with all data
+  and a list of address ranges). Finally the run lists are added in file
+  order to the map or memory image, so that contiguous address ranges across
+  chunk borders are merged exactly as coReadS19ByFP() does.
+*/
+
+#define CO_S19_THREAD_MAX 64
+#define CO_S19_CHUNKS_PER_THREAD 4
+#define CO_S19_CHUNK_MIN (64 * 1024)
+
+struct co_s19_chunk_struct {
+  const char *start;
+  const char *end;
+  struct co_mem_target_struct target; // run list
+  long line_cnt; // number of lines or the failed line
+  int result;    // result of coS19ReadLines()
+};
+
+struct co_s19_job_struct {
+  struct co_s19_chunk_struct *chunk_list;
+  long chunk_cnt;
+  long next; // next chunk to decode, protected by mutex
+  pthread_mutex_t mutex;
+  unsigned flags;
+};
+
+/*
+  split [s, e) into max. chunk_max chunks. A chunk starts at the beginning of a
+  line, which doesn't start with white space, so that the line count of the
+  chunks is identical to the serial read. returns the number of chunks
+*/
+static long coS19Split(const char *s, const char *e, long chunk_max,
+                       struct co_s19_chunk_struct *chunk_list) {
+  size_t chunk_size = (e - s) / chunk_max;
+  const char *p = s;
+  long cnt = 0;
+  if (chunk_size < CO_S19_CHUNK_MIN)
+    chunk_size = CO_S19_CHUNK_MIN;
+  chunk_list[0].start = s;
+  while (cnt + 1 < chunk_max && (size_t)(e - p) > chunk_size) {
+    p += chunk_size;
+    for (;;) {
+      p = (const char *)memchr(p, '\n', e - p);
+      if (p == NULL || p + 1 >= e)
+        break;
+      p++;
+      if (*(const unsigned char *)p > ' ')
+        break;
+    }
+    if (p == NULL || p + 1 >= e)
+      break;
+    chunk_list[cnt].end = p;
+    cnt++;
+    chunk_list[cnt].start = p;
+  }
+  chunk_list[cnt].end = e;
+  return cnt + 1;
+}
+
+static void *coS19ReadThread(void *data) {
+  struct co_s19_job_struct *job = (struct co_s19_job_struct *)data;
+  struct co_reader_struct reader;
+  struct co_s19_chunk_struct *chunk;
+  long i;
+
+  for (;;) {
+    pthread_mutex_lock(&(job->mutex));
+    i = job->next++;
+    pthread_mutex_unlock(&(job->mutex));
+    if (i >= job->chunk_cnt)
+      break;
+    chunk = job->chunk_list + i;
+    chunk->result = CO_S19_MEMORY_ERROR;
+    coMemTargetInit(&(chunk->target), coNewMem(), NULL, 0);
+    if (chunk->target.o == NULL ||
+        coMemReserve(chunk->target.o, (chunk->end - chunk->start) / 2) == 0)
+      continue;
+    if (coReaderInitByMem(&reader, chunk->start, chunk->end - chunk->start))
+      chunk->result = coS19ReadLines(&reader, &(chunk->target), job->flags,
+                                     &(chunk->line_cnt));
+  }
+  return NULL;
+}
+
+/*
+  decode the S19 data [s, e) with thread_cnt threads into o (map or memory
+  image), o is deleted on error
+*/
+static co coS19ReadParallel(const char *s, const char *e, int thread_cnt,
+                            co o, unsigned flags) {
+  struct co_s19_job_struct job;
+  struct co_mem_target_struct target;
+  pthread_t thread_list[CO_S19_THREAD_MAX];
+  long line_nr = 0;
+  size_t total = 0;
+  int result = CO_S19_OK;
+  long i;
+
+  if (o == NULL)
+    return NULL;
+  if (thread_cnt > CO_S19_THREAD_MAX)
+    thread_cnt = CO_S19_THREAD_MAX;
+  job.chunk_list = (struct co_s19_chunk_struct *)malloc(
+      sizeof(struct co_s19_chunk_struct) * thread_cnt *
+      CO_S19_CHUNKS_PER_THREAD);
+  if (job.chunk_list == NULL)
+    return coDelete(o), NULL;
+  job.chunk_cnt =
+      coS19Split(s, e, thread_cnt * CO_S19_CHUNKS_PER_THREAD, job.chunk_list);
+  for (i = 0; i < job.chunk_cnt; i++) {
+    job.chunk_list[i].target.o = NULL;
+    job.chunk_list[i].target.run_list = NULL;
+    job.chunk_list[i].line_cnt = 0;
+    job.chunk_list[i].result = CO_S19_MEMORY_ERROR;
+  }
+  job.flags = flags;
+  job.next = 0;
+  pthread_mutex_init(&(job.mutex), NULL);
+  if (thread_cnt > job.chunk_cnt)
+    thread_cnt = job.chunk_cnt;
+  for (i = 0; i < thread_cnt; i++)
+    if (pthread_create(thread_list + i, NULL, coS19ReadThread, &job) != 0)
+      break;
+  thread_cnt = i; // number of started threads
+  if (thread_cnt == 0) // no thread was started
+    coS19ReadThread(&job);
+  for (i = 0; i < thread_cnt; i++)
+    pthread_join(thread_list[i], NULL);
+  pthread_mutex_destroy(&(job.mutex));
+
+  // the exact size of the data is known now
+  for (i = 0; i < job.chunk_cnt; i++)
+    if (job.chunk_list[i].target.o != NULL)
+      total += coMemSize(job.chunk_list[i].target.o);
+  coMemTargetInit(&target, o, NULL, 0);
+  target.reserve = total;
+
+  // merge the run lists in file order, release each chunk after the merge
+  for (i = 0; i < job.chunk_cnt; i++) {
+    if (result == CO_S19_OK) {
+      result = job.chunk_list[i].result;
+      line_nr += job.chunk_list[i].line_cnt;
+      if (result == CO_S19_OK &&
+          coMemTargetAddRunList(&target, &(job.chunk_list[i].target)) == 0)
+        result = CO_S19_MEMORY_ERROR;
+    }
+    coDelete(job.chunk_list[i].target.o);
+    free(job.chunk_list[i].target.run_list);
+  }
+  free(job.chunk_list);
+  if (result == CO_S19_OK && coMemTargetFinish(&target) == 0)
+    result = CO_S19_MEMORY_ERROR;
+  if (result != CO_S19_OK)
+    return coDelete(o), coS19Error(result, line_nr);
+  return o;
+}
+
+/*
+  same as coReadS19ByFPWithFlags(), but decode the file with thread_cnt
+  threads. The file is mapped into memory, gzip files are read with
+  coReadS19ByFPWithFlags().
+  flags: CO_READ_MEM_IMAGE, CO_READ_CHECKSUM
+*/
+co coReadS19ByFPParallel(FILE *fp, int thread_cnt, unsigned flags) {
+  struct co_reader_struct reader;
+  coArena a;
+  co o;
+  if (thread_cnt > 1) {
+    a = coNewArena(0); // owner of the file mapping
+    if (a == NULL)
+      return NULL;
+    if (coReaderInitByMmap(&reader, fp, a) && coReaderCurr(&reader) >= 0) {
+      if (flags & CO_READ_MEM_IMAGE)
+        o = coNewMemImage();
+      else
+        o = coNewMap(CO_FREE_VALS | CO_STRDUP);
+      o = coS19ReadParallel((const char *)coReaderWindow(&reader) - 1,
+                            (const char *)coReaderWindow(&reader) +
+                                coReaderWindowSize(&reader),
+                            thread_cnt, o, flags);
+      coDeleteArena(a);
+      return o;
+    }
+    coDeleteArena(a);
+    fseek(fp, 0, SEEK_SET);
+  }
+  return coReadS19ByFPWithFlags(fp, flags);
 }
 
 /*===================================================================*/
@@ -402,59 +1236,41 @@ co coReadS19ByFP(FILE *fp) {
 
 #define HEX_MAX_LINE_LEN 1024
 
-co coReadHEXByFP(FILE *fp) {
+/*
+  reads the HEX file into o (map or memory image), o is deleted on error.
+  flags: CO_READ_CHECKSUM
+*/
+static co coReadHEXToObject(FILE *fp, co o, unsigned flags) {
   char buf[HEX_MAX_LINE_LEN];
   unsigned char mem[HEX_MAX_LINE_LEN / 2];
-  char addr_as_hex[10];
   char *line;
   size_t rec_address = 0x0;
   size_t seg_address = 0x0;
-  size_t last_address = 0xffffffff;
   size_t address = 0x0;
   size_t mem_cnt;
   int rec_type;
-  int i, c;
+  long i;
+  long line_nr = 0;
+  unsigned long sum; // sum of all record bytes, including the checksum
   struct co_reader_struct reader_struct;
+  struct co_mem_target_struct target;
 
   coReader r = &reader_struct;
   coReaderInitByFP(r, fp);
 
-  co mo = NULL; // memory object
-  co map = coNewMap(CO_FREE_VALS | CO_STRDUP);
-  if (map == NULL)
+  if (o == NULL)
     return NULL;
+  coMemTargetInit(&target, o, fp, 2); // two hex digits per data byte
   for (;;) {
-    i = 0;
-    for (;;) {
-      c = coReaderCurr(r);
-      coReaderNext(r);
-      if (c < 0) {
-        if (i == 0)
-          line = NULL;
-        else {
-          line = buf;
-          buf[i] = '\0';
-        }
-        break;
-      }
-
-      if (c == '\n' || c == '\r') {
-        line = buf;
-        buf[i] = '\0';
-        break;
-      }
-      if (i >= HEX_MAX_LINE_LEN)
-        return puts("illegal line length in hex file"), coDelete(map), NULL;
-      if (c > ' ')
-        buf[i++] = c;
-      else
-        i++;
-    }
-
-    // printf("line %s, i=%d\n", line, i);
-
-    if (line == NULL)
+    i = coReaderGetLine(r, buf, HEX_MAX_LINE_LEN, '\r');
+    if (i == -2)
+      return puts("illegal line length in hex file"), coDelete(o), NULL;
+    if (i < 0)
       break;
+    line = buf;
+    line_nr++;
+
+    // printf("line %s, i=%ld\n", line, i);
 
     while (*line != ':' && *line != '\0')
       line++;
@@ -466,40 +1282,33 @@ co coReadHEXByFP(FILE *fp) {
       line++;
 
     mem_cnt = hexToUnsigned(line);
-    if ((mem_cnt + 5) * 2 + 1 > i) // +1 because of the ":"
-      return puts("count mismatch in hex file"), coDelete(map), NULL;
+    if ((mem_cnt + 5) * 2 + 1 > (size_t)i) // +1 because of the ":"
+      return puts("count mismatch in hex file"), coDelete(o), NULL;
     // if ( byte_cnt > 255 )
     //   return puts("wrong byte_cnt"), coDelete(map), NULL;
-    hexToMem(line, (mem_cnt + 5),
-             mem); // simply read all, including byte cnt and checksum
+    sum = 0;
+    hexToMem(line, (mem_cnt + 5), mem,
+             &sum); // simply read all, including byte cnt and checksum
+    // the two's complement checksum: sum of all bytes is 0
+    if ((flags & CO_READ_CHECKSUM) && (sum & 0xff) != 0)
+      return printf("checksum error in hex file, line %ld\n", line_nr),
+             coDelete(o), NULL;
 
     rec_address = mem[1] * 256 + mem[2];
     rec_type = mem[3];
     if (rec_type == 0) {
       address = seg_address + rec_address;
       // address = rec_address;
-      sprintf(addr_as_hex, "%08zX", address);
-      // printf("%lld %llu %s\n", seg_address, address, addr_as_hex);
-      if (mo == NULL || last_address != address) {
-        mo = coNewMem(); // create a new memory block
-        if (coMemAdd(mo, mem + 4, mem_cnt) == 0)
-          return coDelete(map), NULL;
-        if (coMapAdd(map, addr_as_hex, mo) == 0)
-          return coDelete(map), NULL;
-      } else {
-        if (coMemAdd(mo, mem + 4, mem_cnt) ==
-            0) // extend the existing memory block
-          return coDelete(map), NULL;
-      }
-      last_address = address + mem_cnt;
+      if (coMemTargetAdd(&target, address, mem + 4, mem_cnt) == 0)
+        return coDelete(o), NULL;
     } else if (rec_type == 1) {
       // printf("rec_type %d, EOF\n", rec_type);
-      return map;
+      break;
     } else if (rec_type == 2) {
       // printf("rec_type %d, seg_address=%lx\n", rec_type, (unsigned
       // long)seg_address);
       seg_address = ((size_t)mem[4] * 256 + (size_t)mem[5]) * 16;
-      return map;
+      break;
     } else if (rec_type == 3) {
       // printf("rec_type %d, ignored\n", rec_type);
       // start address ignored
@@ -512,42 +1321,58 @@ co coReadHEXByFP(FILE *fp) {
       // start address ignored
     }
   } // for(;;)
-  return map;
+  if (coMemTargetFinish(&target) == 0)
+    return coDelete(o), NULL;
+  return o;
+}
+
+co coReadHEXByFP(FILE *fp) {
+  return coReadHEXToObject(fp, coNewMap(CO_FREE_VALS | CO_STRDUP), CO_NONE);
+}
+
+co coReadHEXMemImageByFP(FILE *fp) {
+  return coReadHEXToObject(fp, coNewMemImage(), CO_NONE);
+}
+
+/* flags: CO_READ_MEM_IMAGE, CO_READ_CHECKSUM */
+co coReadHEXByFPWithFlags(FILE *fp, unsigned flags) {
+  if (flags & CO_READ_MEM_IMAGE)
+    return coReadHEXToObject(fp, coNewMemImage(), flags);
+  return coReadHEXToObject(fp, coNewMap(CO_FREE_VALS | CO_STRDUP), flags);
 }
 
 /*===================================================================*/
 /* ELF Memory Reader */
 /*===================================================================*/
 
-co coReadElfMemoryByFP(FILE *fp) {
+/* reads the ELF file into o (map or memory image), o is deleted on error */
+static co coReadElfToObject(FILE *fp, co o) {
   Elf *elf = NULL;
   Elf_Scn *scn = NULL;
   GElf_Shdr shdr;
   size_t block_addr = 0;
-  size_t last_block_addr = 0;
-  char addr_as_hex[10];
-  co mo = NULL; // memory object
-  co map = NULL;
+  struct co_mem_target_struct target;
+
+  if (o == NULL)
+    return NULL; // memory failure
 
   if (elf_version(EV_CURRENT) == EV_NONE)
-    return NULL; // incorrect version
+    return coDelete(o), NULL; // incorrect version
 
   elf = elf_begin(fileno(fp), ELF_C_READ, NULL);
 
   if (elf == NULL)
-    return NULL; // probably not an object/archive file
+    return coDelete(o), NULL; // probably not an object/archive file
 
   if (elf_kind(elf) != ELF_K_ELF)
-    return elf_end(elf), NULL; // not an ELF file
+    return elf_end(elf), coDelete(o), NULL; // not an ELF file
 
-  map = coNewMap(CO_FREE_VALS | CO_STRDUP);
-  if (map == NULL)
-    return elf_end(elf), coDelete(map), NULL; // memory failure
+  coMemTargetInit(&target, o, fp, 0); // sections are added as a whole
 
   /* loop over all sections of the elf file */
   while ((scn = elf_nextscn(elf, scn)) != NULL) {
     if (gelf_getshdr(scn, &shdr) != &shdr)
-      return elf_end(elf), coDelete(map),
+      return elf_end(elf), coDelete(o),
              NULL; // unable to get the section header
     if ((shdr.sh_flags & SHF_ALLOC) != 0 && shdr.sh_size > 0) {
       /* loop over the data blocks of the section */
@@ -564,52 +1389,86 @@ co coReadElfMemoryByFP(FILE *fp) {
             shdr.sh_addr +
             data->d_off; // calculate the address of this data in the target
                          // system, not 100% sure whether this is correct
-        sprintf(addr_as_hex, "%08zX", block_addr);
-        if (mo == NULL ||
-            last_block_addr != block_addr) // start a new memory block?
-        {
-          mo = coNewMem(); // create a new memory block
-          if (coMemAdd(mo, (unsigned char *)(data->d_buf), data->d_size) ==
-              0) // data->d_size contains the size of the block, data->d_buf a
-                 // ptr to the internal memory
-            return elf_end(elf), coDelete(map), NULL;
-          if (coMapAdd(map, addr_as_hex, mo) ==
-              0) // append the memory to the map
-            return elf_end(elf), coDelete(map), NULL;
-        } else // else: extend memory block
-        {
-          if (coMemAdd(mo, (unsigned char *)(data->d_buf), data->d_size) ==
-              0) // extend the existing memory block
-            return elf_end(elf), coDelete(map), NULL;
-        }
-        last_block_addr = block_addr + data->d_size;
+        // data->d_size contains the size of the block, data->d_buf a ptr to
+        // the internal memory
+        if (coMemTargetAdd(&target, block_addr,
+                           (const unsigned char *)(data->d_buf),
+                           data->d_size) == 0)
+          return elf_end(elf), coDelete(o), NULL;
       } // with all data blocks within a section
     } // memory section?
   } // with all sections
-  return elf_end(elf), map;
+  if (coMemTargetFinish(&target) == 0)
+    return elf_end(elf), coDelete(o), NULL;
+  return elf_end(elf), o;
+}
+
+co coReadElfMemoryByFP(FILE *fp) {
+  return coReadElfToObject(fp, coNewMap(CO_FREE_VALS | CO_STRDUP));
+}
+
+co coReadElfMemImageByFP(FILE *fp) {
+  return coReadElfToObject(fp, coNewMemImage());
 }
 
 /*===================================================================*/
-/* CSV Reader, https://www.rfc-editor.org/rfc/rfc4180 */
+/* CSV Field Scanner, https://www.rfc-editor.org/rfc/rfc4180 */
 /*===================================================================*/
 
-#define CO_CSV_FIELD_STRING_MAX (32 * 1024)
-
-cco coNewCSVStr(const char *s, co pool) {
+/*
+  string object for a CSV field with len bytes, the field may contain '\0'.
+  The keys of a map pool are '\0' terminated, so a field with '\0' can not be
+  stored in a map pool and NULL is returned.
+*/
+cco coNewCSVStr(const char *s, size_t len, co pool) {
   if (pool == NULL)
-    return coNewStr(CO_STRDUP, s);
+    return coNewStrWithLen(s, len);
+  if (coIsStrPool(pool))
+    return coStrPoolAdd(pool, s, len);
+  if (memchr(s, '\0', len) != NULL)
+    return NULL;
   return coMapAddValueKey(pool, s);
 }
 
-cco coGetCSVField(struct co_reader_struct *r, int separator, char *buf,
-                  co pool) {
-  size_t idx = 0;
+/*
+  make room for n more chars at (*buf)[idx] plus the terminating '\0'.
+  returns 0 for memory error
+*/
+static int coCSVBufGrow(char **buf, size_t *size, size_t idx, size_t n) {
+  size_t new_size = *size;
+  char *p;
+  if (idx + n + 1 <= *size)
+    return 1;
+  while (idx + n + 1 > new_size)
+    new_size *= 2;
+  p = (char *)realloc(*buf, new_size);
+  if (p == NULL)
+    return 0;
+  *buf = p;
+  *size = new_size;
+  return 1;
+}
+
+/*
+  read the next field and store it '\0' terminated at (*buf)[idx]. *buf is
+  allocated with malloc() and will be extended with realloc().
+  The chars without special meaning are found with coScanCSVField() (outside
+  of double quotes) or memchr() (inside double quotes) and copied as one block
+  from the reader window, so only double quotes, separators and line ends are
+  handled char by char.
+  returns the index of the terminating '\0', -1 at the end of the file and
+  -2 for a memory error.
+*/
+static long coCSVScanField(struct co_reader_struct *r, int separator,
+                           char **buf, size_t *size, size_t idx) {
   int isQuote = 0;
   int c;
+  const unsigned char *p;
+  size_t n;
 
   c = coReaderCurr(r);
   if (c < 0)
-    return NULL;
+    return -1;
   if (c == '\"') {
     isQuote = 1;
     coReaderNext(r);
@@ -617,9 +1476,7 @@ cco coGetCSVField(struct co_reader_struct *r, int separator, char *buf,
   }
   for (;;) {
     if (c < 0) {
-      buf[idx] = '\0';
-      return coNewCSVStr(buf, pool);
-      // return coNewStr(CO_STRDUP, buf);
+      break;
     } else if (c == '\"') {
       coReaderNext(r);
       c = coReaderCurr(r);
@@ -627,92 +1484,117 @@ cco coGetCSVField(struct co_reader_struct *r, int separator, char *buf,
         if (c == '\"') // double double quote == escaped double quote
         {
           // storing is done at the end of the for-loop body
-          // buf[idx++] = '\"';	// store double quote and continue
         } else // end of field, lets look for the separator
         {
-          for (;;) {
-            if (c < 0) {
-              buf[idx] = '\0';
-              return coNewCSVStr(buf, pool);
-              // return coNewStr(CO_STRDUP, buf);
-            }
-            if (c == separator) {
-              buf[idx] = '\0';
-              return coNewCSVStr(buf, pool);
-              // return coNewStr(CO_STRDUP, buf);	// separator will be
-              // handled by calling function
-            }
-            if (c == '\n' ||
-                c == '\r') // let the calling function handle  \n and \r
-            {
-              buf[idx] = '\0';
-              return coNewCSVStr(buf, pool);
-              // return coNewStr(CO_STRDUP, buf);
-            }
+          // separator, \n and \r will be handled by calling function
+          while (c >= 0 && c != separator && c != '\n' && c != '\r') {
             coReaderNext(r);
             c = coReaderCurr(r);
           }
-          /* we will never come here */
+          break;
         }
       } else {
         // double quote was found, but we are not in double quote mode, so just
         // store the double quote storing is done at the end of the for-loop
         // body
-        // buf[idx++] = '\"';	// store double quote and continue
       }
-    } else if (c == separator) {
+    } else if (c == separator || c == '\n' || c == '\r') {
       if (isQuote) {
-        // we are inside double quotes, so just store the separator (which is
-        // done at the end of the for loop)
+        // we are inside double quotes, so just store the separator or the
+        // CR/LF sequence (which is done at the end of the for loop)
       } else {
-        // end of field found... separator will be handled by calling function
-        buf[idx] = '\0';
-        return coNewCSVStr(buf, pool);
-        // return coNewStr(CO_STRDUP, buf);
-      }
-    } else if (c == '\n' || c == '\r') {
-      if (isQuote) {
-        // CR/LF inside double quotes: just continue and store the CRLR sequence
-      } else { // let the calling function handle  \n and \r
-        buf[idx] = '\0';
-        return coNewCSVStr(buf, pool);
-        // return coNewStr(CO_STRDUP, buf);
+        // end of field found... separator, \n and \r will be handled by
+        // calling function
+        break;
       }
     }
 
-    assert(idx < CO_CSV_FIELD_STRING_MAX);
-    buf[idx++] = c;
-    coReaderNext(r);
+    // find all following chars without special meaning in the reader window
+    if (isQuote) {
+      p = (const unsigned char *)memchr(coReaderWindow(r), '\"',
+                                        coReaderWindowSize(r));
+      n = p == NULL ? coReaderWindowSize(r) : (size_t)(p - coReaderWindow(r));
+    } else {
+      n = coScanCSVField(coReaderWindow(r), coReaderWindowSize(r), separator);
+    }
+
+    if (coCSVBufGrow(buf, size, idx, n + 1) == 0)
+      return -2;
+    (*buf)[idx++] = c;
+    memcpy(*buf + idx, coReaderWindow(r), n);
+    idx += n;
+    coReaderSkip(r, n + 1);
     c = coReaderCurr(r);
   }
-  /* we will never reach this statement */
-  return NULL;
+  (*buf)[idx] = '\0';
+  return (long)idx;
 }
 
-co coGetCSVRowWithBufferAndPool(struct co_reader_struct *r, int separator,
-                                char *buf, co pool) {
-  co rowVector = coNewVector(pool == NULL ? CO_FREE_VALS : CO_NONE);
-  cco field;
+/*===================================================================*/
+/* CSV Cursor */
+/*===================================================================*/
 
-  // puts("coGetCSVRowWithBufferAndPool");
+#define CO_CSV_CURSOR_BUF_SIZE 1024
+#define CO_CSV_CURSOR_FIELD_MAX 16
+
+int coCSVCursorInit(coCSVCursor c, coReader r, int separator) {
+  c->reader = r;
+  c->separator = separator;
+  c->field_cnt = 0;
+  c->field_max = CO_CSV_CURSOR_FIELD_MAX;
+  c->buf_size = CO_CSV_CURSOR_BUF_SIZE;
+  c->row_nr = 0;
+  c->field_list = (struct co_csv_field_struct *)malloc(
+      c->field_max * sizeof(struct co_csv_field_struct));
+  c->buf = (char *)malloc(c->buf_size);
+  if (c->field_list == NULL || c->buf == NULL)
+    return coCSVCursorClose(c), 0;
+  return 1;
+}
+
+void coCSVCursorClose(coCSVCursor c) {
+  free(c->field_list);
+  free(c->buf);
+  c->field_list = NULL;
+  c->buf = NULL;
+  c->field_cnt = 0;
+}
 
+/* the field list stores the start index inside buf until the row is complete */
+static int coCSVCursorAddField(coCSVCursor c, size_t idx, size_t len) {
+  struct co_csv_field_struct *list;
+  if (c->field_cnt >= c->field_max) {
+    list = (struct co_csv_field_struct *)realloc(
+        c->field_list, c->field_max * 2 * sizeof(struct co_csv_field_struct));
+    if (list == NULL)
+      return 0;
+    c->field_list = list;
+    c->field_max *= 2;
+  }
+  c->field_list[c->field_cnt].str = NULL;
+  c->field_list[c->field_cnt].pos = idx;
+  c->field_list[c->field_cnt].len = len;
+  c->field_cnt++;
+  return 1;
+}
+
+/* read the next row without skipping white space before the row */
+static long coCSVCursorReadRow(coCSVCursor c) {
+  coReader r = c->reader;
+  size_t idx = 0;
+  size_t i;
+  long end;
+
+  c->field_cnt = 0;
   for (;;) {
-    field = coGetCSVField(r, separator, buf, pool);
-    if (field == NULL) {
-      if (coVectorSize(rowVector) == 0) {
-        coDelete(rowVector);
-        return NULL;
-      }
+    end = coCSVScanField(r, c->separator, &c->buf, &c->buf_size, idx);
+    if (end == -2)
+      return c->field_cnt = 0, -1;
+    if (end == -1)
       break;
-    }
-
-    // printf("Field %s\n", coStrGet(field));
-    if (coVectorAdd(rowVector, field) < 0) {
-      if (pool == NULL)
-        coDelete((co)field);
-      coDelete(rowVector);
-      return NULL;
-    }
+    if (coCSVCursorAddField(c, idx, (size_t)end - idx) == 0)
+      return c->field_cnt = 0, -1;
+    idx = (size_t)end + 1;
 
     if (coReaderCurr(r) == '\n') {
       coReaderNext(r);
@@ -728,64 +1610,106 @@ co coGetCSVRowWithBufferAndPool(struct co_reader_struct *r, int separator,
       break;
     }
 
-    if (coReaderCurr(r) == separator) {
+    if (coReaderCurr(r) == c->separator) {
       coReaderNext(r);
       // handle the special case, where the separtor is the last char of the
-      // file. in such a case, add an empty string to the row vector
+      // file. in such a case, add an empty field to the row
       if (coReaderCurr(r) < 0) {
-        field = coNewCSVStr("", pool);
-        // field = coNewStr(CO_STRDUP, "");
-        if (coVectorAdd(rowVector, field) < 0) {
-          if (pool == NULL)
-            coDelete((co)field);
-          coDelete(rowVector);
-          return NULL;
-        }
-        return rowVector;
+        if (coCSVBufGrow(&c->buf, &c->buf_size, idx, 0) == 0 ||
+            coCSVCursorAddField(c, idx, 0) == 0)
+          return c->field_cnt = 0, -1;
+        c->buf[idx] = '\0';
+        break;
       }
     }
   }
+  if (c->field_cnt == 0)
+    return 0;
+  // buf has its final size, so the pointers can be calculated now
+  for (i = 0; i < c->field_cnt; i++)
+    c->field_list[i].str = c->buf + c->field_list[i].pos;
+  c->row_nr++;
+  return (long)c->field_cnt;
+}
+
+long coCSVCursorNext(coCSVCursor c) {
+  coReaderSkipWhiteSpace(c->reader);
+  return coCSVCursorReadRow(c);
+}
+
+co coCSVCursorGetRow(coCSVCursor c, co pool) {
+  co rowVector = coNewVector(pool == NULL ? CO_FREE_VALS : CO_NONE);
+  cco field;
+  size_t i;
+
+  if (rowVector == NULL)
+    return NULL;
+  for (i = 0; i < c->field_cnt; i++) {
+    field = coNewCSVStr(c->field_list[i].str, c->field_list[i].len, pool);
+    if (field == NULL)
+      return coDelete(rowVector), NULL;
+    if (coVectorAdd(rowVector, field) < 0) {
+      if (pool == NULL)
+        coDelete((co)field);
+      return coDelete(rowVector), NULL;
+    }
+  }
   return rowVector;
 }
 
-co coGetCSVFile(struct co_reader_struct *reader, int separator, char *buf,
-                co pool) {
-  co fileVector = coNewVector(CO_FREE_VALS);
+/*===================================================================*/
+/* CSV Reader */
+/*===================================================================*/
+
+co coGetCSVFile(struct co_reader_struct *reader, int separator, co pool) {
+  struct co_csv_cursor_struct c;
+  co fileVector;
   co rowVector;
+  long cnt;
 
-  // puts("coGetCSVFile");
+  if (coCSVCursorInit(&c, reader, separator) == 0)
+    return NULL;
+  fileVector = coNewVector(CO_FREE_VALS);
+  if (fileVector == NULL)
+    return coCSVCursorClose(&c), NULL;
 
+  // white space is only skipped at the beginning of the file, empty lines
+  // and leading blanks of the following rows are part of the fields
   coReaderSkipWhiteSpace(reader);
 
   for (;;) {
-    rowVector = coGetCSVRowWithBufferAndPool(reader, separator, buf, pool);
-    if (rowVector == NULL)
+    cnt = coCSVCursorReadRow(&c);
+    if (cnt < 0)
+      return coCSVCursorClose(&c), coDelete(fileVector), NULL;
+    if (cnt == 0)
       break;
+    rowVector = coCSVCursorGetRow(&c, pool);
+    if (rowVector == NULL)
+      return coCSVCursorClose(&c), coDelete(fileVector), NULL;
     if (coVectorAdd(fileVector, rowVector) < 0) {
       coDelete(rowVector);
       coDelete(fileVector);
-      return NULL;
+      return coCSVCursorClose(&c), NULL;
     }
   }
+  coCSVCursorClose(&c);
   return fileVector;
 }
 
 co coReadCSVByFP(FILE *fp, int separator) {
   struct co_reader_struct reader;
-  char buf[CO_CSV_FIELD_STRING_MAX];
 
   if (coReaderInitByFP(&reader, fp) == 0)
     return NULL;
-  return coGetCSVFile(&reader, separator, buf, NULL);
+  return coGetCSVFile(&reader, separator, NULL);
 }
 
 co coReadCSVByFPWithPool(FILE *fp, int separator, co pool) {
   struct co_reader_struct reader;
-  char buf[CO_CSV_FIELD_STRING_MAX];
 
   if (coReaderInitByFP(&reader, fp) == 0)
     return NULL;
-  return coGetCSVFile(&reader, separator, buf, pool);
+  return coGetCSVFile(&reader, separator, pool);
 }
 
 /*
@@ -799,10 +1723,477 @@ co coReadCSVByFPWithPool(FILE *fp, int separator, co pool) {
     coPrint(rowVector); puts("");
     coDelete(rowVector);
   }
+  see also coCSVCursorNext(), which does not create any objects
 */
 
 co coGetCSVRow(struct co_reader_struct *r, int separator) {
-  char buf[CO_CSV_FIELD_STRING_MAX];
-  coReaderSkipWhiteSpace(r);
-  return coGetCSVRowWithBufferAndPool(r, separator, buf, NULL);
+  struct co_csv_cursor_struct c;
+  co rowVector = NULL;
+
+  if (coCSVCursorInit(&c, r, separator) == 0)
+    return NULL;
+  if (coCSVCursorNext(&c) > 0)
+    rowVector = coCSVCursorGetRow(&c, NULL);
+  coCSVCursorClose(&c);
+  return rowVector;
+}
+
+/*===================================================================*/
+/* Parallel CSV Reader */
+/*===================================================================*/
+
+/*
+  The CSV file is mapped into memory and split into chunks after a line
+  feed. A line feed may be part of a quoted field, so each chunk is parsed
+  speculatively: rows are read from the start of the chunk until a row ends
+  at or behind the end of the chunk. A chunk is only used, if it starts
+  exactly where the rows of the previous chunk end, otherwise it is parsed
+  again from the correct position (fix-up).
+  With a map as pool, each chunk uses a chunk local pool. After parsing, the
+  distinct strings of the chunk pools are added to the pool and the rows are
+  updated in parallel to use the strings of the pool. A string pool is used
+  by all threads directly, strings of a chunk, which is parsed again, remain
+  inside the string pool.
+*/
+
+#define CO_CSV_THREAD_MAX 64
+#define CO_CSV_CHUNKS_PER_THREAD 4
+#define CO_CSV_CHUNK_MIN (64 * 1024)
+
+struct co_csv_chunk_struct {
+  const char *start;
+  const char *end;
+  const char *row_end; // end of the last row of this chunk
+  co row_list; // vector with the rows of this chunk
+  co pool; // chunk local pool, NULL if no pool or a string pool is used
+  int is_ok; // 0 for memory error
+};
+
+struct co_csv_job_struct {
+  struct co_csv_chunk_struct *chunk_list;
+  long chunk_cnt;
+  long next; // next chunk, protected by mutex
+  pthread_mutex_t mutex;
+  const char *file_end;
+  int separator;
+  co pool; // pool of the caller or NULL
+  int is_remap; // 0: parse the chunks, 1: use the strings of "pool"
+};
+
+/*
+  split [s, e) into max. chunk_max chunks with at least chunk_min bytes
+  (0: CO_CSV_CHUNK_MIN). A chunk starts after a '\n', which is not followed
+  by '\r' ("\n\r" is one line end for the CSV reader).
+  returns the number of chunks
+*/
+static long coCSVSplit(const char *s, const char *e, long chunk_max,
+                       size_t chunk_min,
+                       struct co_csv_chunk_struct *chunk_list) {
+  size_t chunk_size = (e - s) / chunk_max;
+  const char *p = s;
+  long cnt = 0;
+  if (chunk_min == 0)
+    chunk_min = CO_CSV_CHUNK_MIN;
+  if (chunk_size < chunk_min)
+    chunk_size = chunk_min;
+  chunk_list[0].start = s;
+  while (cnt + 1 < chunk_max && (size_t)(e - p) > chunk_size) {
+    p += chunk_size;
+    for (;;) {
+      p = (const char *)memchr(p, '\n', e - p);
+      if (p == NULL || p + 1 >= e)
+        break;
+      p++;
+      if (*p != '\r')
+        break;
+    }
+    if (p == NULL || p + 1 >= e)
+      break;
+    chunk_list[cnt].end = p;
+    cnt++;
+    chunk_list[cnt].start = p;
+  }
+  chunk_list[cnt].end = e;
+  return cnt + 1;
+}
+
+/* position of the current char of a memory reader */
+static const char *coCSVReaderPos(coReader r, const char *file_end) {
+  if (coReaderCurr(r) < 0)
+    return file_end;
+  return (const char *)coReaderWindow(r) - 1;
+}
+
+/* read the rows, which start inside the chunk, the last row may end behind the
+ * chunk */
+static void coCSVReadChunk(struct co_csv_chunk_struct *chunk,
+                           const char *file_end, int separator, co pool,
+                           int is_file_start) {
+  struct co_reader_struct reader;
+  struct co_csv_cursor_struct c;
+  co row;
+  long cnt = 1;
+
+  chunk->is_ok = 0;
+  chunk->row_end = chunk->start;
+  chunk->row_list = coNewVector(CO_FREE_VALS);
+  chunk->pool = NULL;
+  if (pool != NULL && coIsStrPool(pool) == 0) {
+    chunk->pool = coNewMap(CO_FREE_VALS);
+    if (chunk->pool == NULL)
+      return;
+    pool = chunk->pool;
+  }
+  if (chunk->row_list == NULL)
+    return;
+  if (coReaderInitByMem(&reader, chunk->start, file_end - chunk->start) == 0)
+    return;
+  if (is_file_start == 0) {
+    // coReaderInitByMem() skips white space, but inside the file white space
+    // belongs to the fields (see coGetCSVFile()), so start again at the first
+    // char
+    reader.ptr = (const unsigned char *)chunk->start;
+    coReaderNext(&reader);
+  }
+  if (coCSVCursorInit(&c, &reader, separator) == 0)
+    return;
+  while (coCSVReaderPos(&reader, file_end) < chunk->end) {
+    cnt = coCSVCursorReadRow(&c);
+    if (cnt <= 0)
+      break;
+    row = coCSVCursorGetRow(&c, pool);
+    if (row == NULL || coVectorAdd(chunk->row_list, row) < 0) {
+      coDelete(row);
+      cnt = -1;
+      break;
+    }
+  }
+  chunk->row_end = coCSVReaderPos(&reader, file_end);
+  chunk->is_ok = cnt >= 0;
+  coCSVCursorClose(&c);
+}
+
+/* replace the strings of the chunk pool by the same strings of "pool" */
+static void coCSVRemapChunk(struct co_csv_chunk_struct *chunk, cco pool) {
+  long i, j;
+  co row;
+  for (i = 0; i < coVectorSize(chunk->row_list); i++) {
+    row = (co)coVectorGet(chunk->row_list, i);
+    for (j = 0; j < coVectorSize(row); j++)
+      coVectorSet(row, j, coMapGet(pool, coStrGet(coVectorGet(row, j))));
+  }
+}
+
+static void *coCSVReadThread(void *data) {
+  struct co_csv_job_struct *job = (struct co_csv_job_struct *)data;
+  struct co_csv_chunk_struct *chunk;
+  long i;
+
+  for (;;) {
+    pthread_mutex_lock(&(job->mutex));
+    i = job->next++;
+    pthread_mutex_unlock(&(job->mutex));
+    if (i >= job->chunk_cnt)
+      break;
+    chunk = job->chunk_list + i;
+    if (job->is_remap) {
+      if (chunk->pool != NULL)
+        coCSVRemapChunk(chunk, job->pool);
+    } else {
+      coCSVReadChunk(chunk, job->file_end, job->separator, job->pool, i == 0);
+    }
+  }
+  return NULL;
+}
+
+/* execute coCSVReadThread() with thread_cnt threads, returns the number of threads (1: no thread was started) */
+static int coCSVRunThreads(struct co_csv_job_struct *job, int thread_cnt) {
+  pthread_t thread_list[CO_CSV_THREAD_MAX];
+  int i;
+  job->next = 0;
+  if (thread_cnt > job->chunk_cnt)
+    thread_cnt = job->chunk_cnt;
+  for (i = 0; i < thread_cnt; i++)
+    if (pthread_create(thread_list + i, NULL, coCSVReadThread, job) != 0)
+      break;
+  thread_cnt = i; // number of started threads
+  if (thread_cnt == 0) // no thread was started
+    coCSVReadThread(job);
+  for (i = 0; i < thread_cnt; i++)
+    pthread_join(thread_list[i], NULL);
+  return thread_cnt == 0 ? 1 : thread_cnt;
+}
+
+static int coCSVAddPoolCB(cco o, long idx, const char *key, cco value,
+                          void *data) {
+  return coMapAddValueKey((co)data, key) != NULL;
+}
+
+/* parse the CSV data [s, e) with thread_cnt threads, info can be NULL */
+static co coCSVReadParallel(const char *s, const char *e, int separator,
+                            co pool, int thread_cnt, coParallelInfo *info) {
+  struct co_csv_job_struct job;
+  struct co_csv_chunk_struct *chunk;
+  co fileVector = NULL;
+  int is_ok = 1;
+  long i;
+  long reparse_cnt = 0;
+
+  if (thread_cnt > CO_CSV_THREAD_MAX)
+    thread_cnt = CO_CSV_THREAD_MAX;
+  job.chunk_list = (struct co_csv_chunk_struct *)malloc(
+      sizeof(struct co_csv_chunk_struct) * thread_cnt *
+      CO_CSV_CHUNKS_PER_THREAD);
+  if (job.chunk_list == NULL)
+    return NULL;
+  job.chunk_cnt =
+      coCSVSplit(s, e, thread_cnt * CO_CSV_CHUNKS_PER_THREAD,
+                 info == NULL ? 0 : info->chunk_size, job.chunk_list);
+  job.file_end = e;
+  job.separator = separator;
+  job.pool = pool;
+  job.is_remap = 0;
+  pthread_mutex_init(&(job.mutex), NULL);
+  thread_cnt = coCSVRunThreads(&job, thread_cnt);
+
+  // fix-up: parse a chunk again, if the previous chunk ends at a different
+  // position (line feed inside a quoted field)
+  for (i = 1; i < job.chunk_cnt; i++) {
+    chunk = job.chunk_list + i;
+    if (chunk->start == chunk[-1].row_end)
+      continue;
+    coDelete(chunk->row_list);
+    coDelete(chunk->pool);
+    chunk->start = chunk[-1].row_end;
+    if (chunk->start > chunk->end)
+      chunk->end = chunk->start; // all rows are already read
+    coCSVReadChunk(chunk, e, separator, pool, 0);
+    reparse_cnt++;
+  }
+  for (i = 0; i < job.chunk_cnt; i++)
+    if (job.chunk_list[i].is_ok == 0)
+      is_ok = 0;
+
+  if (is_ok && pool != NULL && coIsStrPool(pool) == 0) {
+    // the pool is only read by the threads
+    for (i = 0; i < job.chunk_cnt && is_ok; i++)
+      is_ok = coMapForEach(job.chunk_list[i].pool, coCSVAddPoolCB, pool);
+    job.is_remap = 1;
+    if (is_ok)
+      coCSVRunThreads(&job, thread_cnt);
+  }
+  pthread_mutex_destroy(&(job.mutex));
+
+  // concatenate the rows in file order
+  if (is_ok)
+    fileVector = coNewVector(CO_FREE_VALS);
+  for (i = 0; i < job.chunk_cnt; i++) {
+    if (fileVector != NULL &&
+        coVectorMoveVector(fileVector, job.chunk_list[i].row_list) == 0)
+      fileVector = (coDelete(fileVector), NULL);
+    coDelete(job.chunk_list[i].row_list);
+    coDelete(job.chunk_list[i].pool);
+  }
+  if (info != NULL) {
+    info->thread_cnt = thread_cnt;
+    info->chunk_cnt = job.chunk_cnt;
+    info->reparse_cnt = reparse_cnt;
+  }
+  free(job.chunk_list);
+  return fileVector;
+}
+
+/*
+  same as coReadCSVByFPWithPool(), but parse the file with thread_cnt
+  threads. The file is mapped into memory, other files (e.g. gzip) are read
+  with coReadCSVByFPWithPool(). pool and info can be NULL.
+*/
+co coReadCSVByFPParallelWithInfo(FILE *fp, int separator, co pool,
+                                 int thread_cnt, coParallelInfo *info) {
+  struct co_reader_struct reader;
+  coArena a;
+  co o;
+  if (info != NULL) {
+    info->thread_cnt = 0;
+    info->chunk_cnt = 0;
+    info->reparse_cnt = 0;
+  }
+  if (thread_cnt > 1) {
+    a = coNewArena(0); // owner of the file mapping
+    if (a == NULL)
+      return NULL;
+    if (coReaderInitByMmap(&reader, fp, a) && coReaderCurr(&reader) >= 0) {
+      o = coCSVReadParallel((const char *)coReaderWindow(&reader) - 1,
+                            (const char *)coReaderWindow(&reader) +
+                                coReaderWindowSize(&reader),
+                            separator, pool, thread_cnt, info);
+      coDeleteArena(a);
+      return o;
+    }
+    coDeleteArena(a);
+    fseek(fp, 0, SEEK_SET);
+  }
+  return coReadCSVByFPWithPool(fp, separator, pool);
+}
+
+co coReadCSVByFPParallel(FILE *fp, int separator, co pool, int thread_cnt) {
+  return coReadCSVByFPParallelWithInfo(fp, separator, pool, thread_cnt, NULL);
+}
+
+/*===================================================================*/
+/* CSV Table Reader */
+/*===================================================================*/
+
+/* returns CO_COL_... or -1 */
+static int coCSVTableType(const char *s) {
+  if (strcmp(s, "auto") == 0)
+    return CO_COL_AUTO;
+  if (strcmp(s, "int") == 0)
+    return CO_COL_INT;
+  if (strcmp(s, "dbl") == 0)
+    return CO_COL_DBL;
+  if (strcmp(s, "str") == 0)
+    return CO_COL_STR;
+  return -1;
+}
+
+/* header: header line or NULL, returns the field index of "name" or -1 */
+static long coCSVTableFindField(coCSVCursor header, const char *name) {
+  long i;
+  const char *p;
+  if (header != NULL)
+    for (i = 0; i < coCSVCursorCnt(header); i++)
+      if (strcmp(coCSVCursorStr(header, i), name) == 0)
+        return i;
+  for (p = name; *p >= '0' && *p <= '9'; p++)
+    ;
+  if (p == name || *p != '\0')
+    return -1;
+  return atol(name);
+}
+
+/*
+  add the columns of the schema to the table "o" and store the field index of
+  each column in field_list, returns 0 for an unknown column or memory error
+  (the error is reported with coReaderErr())
+*/
+static int coCSVTableAddCols(coReader r, co o, const char *schema,
+                             coCSVCursor header, long *field_list) {
+  char msg[80];
+  char *buf = strdup(schema);
+  char *name;
+  char *next;
+  char *type_str;
+  int type;
+  long idx = 0;
+
+  if (buf == NULL)
+    return coReaderErr(r, "Memory error with csv schema"), 0;
+  for (name = buf; name != NULL; name = next) {
+    next = strchr(name, ',');
+    if (next != NULL)
+      *next++ = '\0';
+    if (*name == '\0') // ignore empty entries
+      continue;
+    type = CO_COL_AUTO;
+    type_str = strrchr(name, ':');
+    if (type_str != NULL && coCSVTableType(type_str + 1) >= 0) {
+      *type_str = '\0'; // "name:type"
+      type = coCSVTableType(type_str + 1);
+    }
+    field_list[idx] = coCSVTableFindField(header, name);
+    if (field_list[idx] < 0) {
+      snprintf(msg, sizeof(msg), "Unknown column '%.40s' in csv schema", name);
+      return coReaderErr(r, msg), free(buf), 0;
+    }
+    if (coTableAddCol(o, name, type) < 0)
+      return coReaderErr(r, "Memory error with table column"), free(buf), 0;
+    idx++;
+  }
+  return free(buf), 1;
+}
+
+/* returns number of entries in the schema */
+static long coCSVTableSchemaCnt(const char *schema) {
+  long cnt = 1;
+  for (; *schema != '\0'; schema++)
+    if (*schema == ',')
+      cnt++;
+  return cnt;
+}
+
+/* read the rows of cursor c into table o, the first row is already read */
+static co coCSVTableRead(co o, coCSVCursor c, long cnt, const char *schema,
+                         unsigned flags) {
+  char name[24];
+  long *field_list;
+  long col_cnt;
+  long i;
+  long f;
+
+  if (cnt == 0) // empty file
+    return o;
+  col_cnt = schema == NULL ? cnt : coCSVTableSchemaCnt(schema);
+  field_list = (long *)malloc(col_cnt * sizeof(long));
+  if (field_list == NULL)
+    return NULL;
+
+  if (schema == NULL) { // all columns of the first row, type is CO_COL_AUTO
+    for (i = 0; i < col_cnt; i++) {
+      sprintf(name, "%ld", i);
+      field_list[i] = i;
+      if (coTableAddCol(o, (flags & CO_CSV_HEADER) ? coCSVCursorStr(c, i) : name,
+                        CO_COL_AUTO) < 0)
+        return free(field_list), NULL;
+    }
+  } else {
+    if (coCSVTableAddCols(c->reader, o, schema,
+                          (flags & CO_CSV_HEADER) ? c : NULL, field_list) == 0)
+      return free(field_list), NULL;
+    col_cnt = coTableColCnt(o); // without empty entries
+  }
+
+  // same rows as coGetCSVFile(): white space is only skipped at the
+  // beginning of the file, empty lines and leading blanks are part of the
+  // fields
+  if (flags & CO_CSV_HEADER)
+    cnt = coCSVCursorReadRow(c);
+  while (cnt > 0) {
+    // fields, which are not part of the table, are not converted or stored
+    for (i = 0; i < col_cnt; i++) {
+      f = field_list[i];
+      if (f < cnt) {
+        if (coTableAddField(o, i, coCSVCursorStr(c, f), coCSVCursorLen(c, f)) == 0)
+          return free(field_list), NULL;
+      } else { // missing field
+        if (coTableAddField(o, i, "", 0) == 0)
+          return free(field_list), NULL;
+      }
+    }
+    cnt = coCSVCursorReadRow(c);
+  }
+  free(field_list);
+  if (cnt < 0)
+    return NULL;
+  return o;
+}
+
+co coReadCSVTableByFP(FILE *fp, int separator, const char *schema,
+                      unsigned flags) {
+  struct co_reader_struct reader;
+  struct co_csv_cursor_struct c;
+  co o;
+
+  if (coReaderInitByFP(&reader, fp) == 0)
+    return NULL;
+  if (coCSVCursorInit(&c, &reader, separator) == 0)
+    return NULL;
+  o = coNewTable();
+  if (o == NULL)
+    return coCSVCursorClose(&c), NULL;
+  if (coCSVTableRead(o, &c, coCSVCursorNext(&c), schema, flags) == NULL ||
+      coTableFinish(o) == 0)
+    return coCSVCursorClose(&c), coDelete(o), NULL;
+  coCSVCursorClose(&c);
+  return o;
 }
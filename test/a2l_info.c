@@ -1,4 +1,4 @@
-/* 
+/*
   a2l_info
   
   a2l info tool, based on C Object Library 
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <sys/time.h>
+#include <sys/stat.h>
 #ifdef USE_PTHREAD
 #include <pthread.h>
 #endif /* USE_PTHREAD */
@@ -37,18 +38,22 @@
 #define BELONGS_TO_FUNCTION_MAP_POS 11	/* DEF_CHARACTERISTIC relationship, maybe also LIST_FUNCTION relationship, key=CHARACTERISTIC or AXIS_PTS name, value: FUNCTION co vector */
 #define FUNCTION_DEF_CHARACTERISTIC_MAP_POS 12  /* opposite of BELONGS_TO_FUNCTION_MAP_POS: key=FUNCTION name, value: map with key=CHARACTERISTIC or AXIS_PTS name, value reference to CHARACTERISTIC or AXIS_PTS */
 #define A2L_POS 13
-#define DATA_MAP_POS 14
-#define DATA_VECTOR_POS 15
+#define DATA_MAP_POS 14		/* memory image of the s19 file, see coNewMemImage() */
 
 #define SW_PAIR_MAX 16
 
 const char *a2l_file_name_list[SW_PAIR_MAX];		// assumes, that global variables are initialized with 0
 const char *s19_file_name_list[SW_PAIR_MAX];		// assumes, that global variables are initialized with 0
 co sw_object_list[SW_PAIR_MAX];					// temporary storage area for sw_objects created from tbe above files
+coArena sw_arena_list[SW_PAIR_MAX];			// arena for the a2l tree of each sw_object, deleted after the sw_objects
+co sw_pool_list[SW_PAIR_MAX];					// string pool for the tokens of the a2l tree, deleted together with the arena
 
 
 int sw_pair_cnt = 0;
 int is_verbose = 0;
+int a2l_thread_cnt = 1;		// number of threads for reading one A2L or S19 file
+const char *cache_dir = NULL;	// directory for the binary snapshots of the a2l/s19 files, NULL: cache not used
+int is_s19_checksum = 0;	// verify the checksum of each s19 record
 int is_ascii_characteristic_list = 0;
 int is_characteristic_address_list = 0;
 int is_function_list = 0;
@@ -72,18 +77,18 @@ co createSWObject(void)
   o = coNewVector(CO_FREE_VALS);
   if ( o == NULL )
     return NULL;  
-  coVectorAdd(o, coNewMap(CO_NONE));          // references to COMPU_METHOD
-  coVectorAdd(o, coNewMap(CO_NONE));          // references to COMPU_VTAB
-  coVectorAdd(o, coNewMap(CO_NONE));          // references to RECORD_LAYOUT
+  coVectorAdd(o, coNewHashMap(CO_NONE));          // references to COMPU_METHOD
+  coVectorAdd(o, coNewHashMap(CO_NONE));          // references to COMPU_VTAB
+  coVectorAdd(o, coNewHashMap(CO_NONE));          // references to RECORD_LAYOUT
   coVectorAdd(o, coNewMap(CO_NONE));          // ADDRESS_MAP_POS: references to CHARACTERISTIC & AXIS_PTS, key = address
-  coVectorAdd(o, coNewMap(CO_NONE));          // CHARACTERISTIC_NAME_MAP_POS: references to CHARACTERISTIC, key = name
-  coVectorAdd(o, coNewMap(CO_NONE));          // AXIS_PTS_NAME_MAP_POS: references to AXIS_PTS, key = name
-  coVectorAdd(o, coNewMap(CO_NONE));          // FUNCTION_NAME_MAP_POS: references to FUNCTION, key = name
+  coVectorAdd(o, coNewHashMap(CO_NONE));          // CHARACTERISTIC_NAME_MAP_POS: references to CHARACTERISTIC, key = name
+  coVectorAdd(o, coNewHashMap(CO_NONE));          // AXIS_PTS_NAME_MAP_POS: references to AXIS_PTS, key = name
+  coVectorAdd(o, coNewHashMap(CO_NONE));          // FUNCTION_NAME_MAP_POS: references to FUNCTION, key = name
   coVectorAdd(o, coNewVector(CO_NONE));          // CHARACTERISTIC_VECTOR_POS: references to CHARACTERISTIC
   coVectorAdd(o, coNewVector(CO_NONE));          // AXIS_PTS_VECTOR_POS: references to AXIS_PTS  
   coVectorAdd(o, coNewVector(CO_NONE));          // FUNCTION_VECTOR_POS: references to FUNCTION
-  coVectorAdd(o, coNewMap(CO_NONE));          // PARENT_FUNCTION_MAP_POS: reference to parent FUNCTION vector, key = name of the (sub-) function, value = parent FUNCTION co vector
-  coVectorAdd(o, coNewMap(CO_NONE));  // BELONGS_TO_FUNCTION_MAP_POS: references from DEF_CHARACTERISTIC to FUNCTION co vector, key = name of the CHARACTERISTIC (or AXIS_PTS), value = parent FUNCTION co vector
+  coVectorAdd(o, coNewHashMap(CO_NONE));          // PARENT_FUNCTION_MAP_POS: reference to parent FUNCTION vector, key = name of the (sub-) function, value = parent FUNCTION co vector
+  coVectorAdd(o, coNewHashMap(CO_NONE));  // BELONGS_TO_FUNCTION_MAP_POS: references from DEF_CHARACTERISTIC to FUNCTION co vector, key = name of the CHARACTERISTIC (or AXIS_PTS), value = parent FUNCTION co vector
   coVectorAdd(o, coNewMap(CO_FREE_VALS));  // FUNCTION_DEF_CHARACTERISTIC_MAP_POS:
   if ( coVectorSize(o) != 13 )
     return NULL;
@@ -111,18 +116,68 @@ struct build_index_struct
 {
 	const char *function_name;
 	cco function_object;
+	/* interned keywords, NULL if the a2l tree was read without string pool */
+	const char *compu_method;
+	const char *compu_vtab;
+	const char *record_layout;
+	const char *characteristic;
+	const char *axis_pts;
+	const char *function;
+	const char *sub_function;
+	const char *def_characteristic;
 };
 
-void buildIndexInit(struct build_index_struct *bis)
+/* returns the interned copy of s, NULL for memory error */
+static const char *getPoolStr(co pool, const char *s)
+{
+	cco o = coStrPoolAdd(pool, s, strlen(s));
+	if ( o == NULL )
+		return NULL;
+	return coStrGet(o);
+}
+
+/*
+  pool: the string pool, which was used to read the a2l tree, can be NULL
+  If the pool is present, then all keywords of the a2l tree point to the strings of the pool
+  and a simple pointer compare is sufficient.
+*/
+void buildIndexInit(struct build_index_struct *bis, co pool)
 {
 	bis->function_name = NULL;
 	bis->function_object = NULL;
+	bis->compu_method = NULL;
+	bis->compu_vtab = NULL;
+	bis->record_layout = NULL;
+	bis->characteristic = NULL;
+	bis->axis_pts = NULL;
+	bis->function = NULL;
+	bis->sub_function = NULL;
+	bis->def_characteristic = NULL;
+	if ( pool == NULL )
+		return;
+	bis->compu_method = getPoolStr(pool, "COMPU_METHOD");
+	bis->compu_vtab = getPoolStr(pool, "COMPU_VTAB");
+	bis->record_layout = getPoolStr(pool, "RECORD_LAYOUT");
+	bis->characteristic = getPoolStr(pool, "CHARACTERISTIC");
+	bis->axis_pts = getPoolStr(pool, "AXIS_PTS");
+	bis->function = getPoolStr(pool, "FUNCTION");
+	bis->sub_function = getPoolStr(pool, "SUB_FUNCTION");
+	bis->def_characteristic = getPoolStr(pool, "DEF_CHARACTERISTIC");
+}
+
+/* compare s with keyword, use the pointer compare if the keyword is interned */
+static int isKeyword(const char *s, const char *interned, const char *keyword)
+{
+	if ( interned != NULL )
+		return s == interned;
+	return strcmp(s, keyword) == 0;
 }
 
 void buildIndexTables(cco sw_object, cco a2l, struct build_index_struct *bis)
 {
   long i, cnt;
   cco element;
+  const char *keyword;
   cnt = coVectorSize(a2l);
   if ( cnt == 0 )
     return;
@@ -130,56 +185,57 @@ void buildIndexTables(cco sw_object, cco a2l, struct build_index_struct *bis)
   if ( coIsStr(element) )
   {
     //puts(coStrToString(element));
-    if ( strcmp( coStrGet(element), "COMPU_METHOD" ) == 0 )
+    keyword = coStrGet(element);
+    if ( isKeyword( keyword, bis->compu_method, "COMPU_METHOD" ) )
     {
-      coMapAdd((co)coVectorGet(sw_object, COMPU_METHOD_MAP_POS), 
+      coHashMapAdd((co)coVectorGet(sw_object, COMPU_METHOD_MAP_POS), 
         coStrGet(coVectorGet(a2l, 1)), 
         a2l);
     }
-    else if ( strcmp( coStrGet(element), "COMPU_VTAB" ) == 0 )
+    else if ( isKeyword( keyword, bis->compu_vtab, "COMPU_VTAB" ) )
     {
-      coMapAdd((co)coVectorGet(sw_object, COMPU_VTAB_MAP_POS), 
+      coHashMapAdd((co)coVectorGet(sw_object, COMPU_VTAB_MAP_POS), 
         coStrGet(coVectorGet(a2l, 1)), 
         a2l);
     }
-    else if ( strcmp( coStrGet(element), "RECORD_LAYOUT" ) == 0 )
+    else if ( isKeyword( keyword, bis->record_layout, "RECORD_LAYOUT" ) )
     {
-      coMapAdd((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), 
+      coHashMapAdd((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), 
         coStrGet(coVectorGet(a2l, 1)),
         a2l);
     }
-    else if ( strcmp( coStrGet(element), "CHARACTERISTIC" ) == 0 )
+    else if ( isKeyword( keyword, bis->characteristic, "CHARACTERISTIC" ) )
     {
 	  const char *characteristic_name = coStrGet(coVectorGet(a2l, 1));
 	  const char *characteristic_address = coStrGet(coVectorGet(a2l, 4));
       coVectorAdd((co)coVectorGet(sw_object, CHARACTERISTIC_VECTOR_POS), a2l);
 
-      coMapAdd((co)coVectorGet(sw_object, CHARACTERISTIC_NAME_MAP_POS), characteristic_name, a2l);
+      coHashMapAdd((co)coVectorGet(sw_object, CHARACTERISTIC_NAME_MAP_POS), characteristic_name, a2l);
 		
       coMapAdd((co)coVectorGet(sw_object, ADDRESS_MAP_POS), characteristic_address, a2l);
     }
-    else if ( strcmp( coStrGet(element), "AXIS_PTS" ) == 0 )
+    else if ( isKeyword( keyword, bis->axis_pts, "AXIS_PTS" ) )
     {
 	  const char *axis_pts_name = coStrGet(coVectorGet(a2l, 1));
 	  const char *axis_pts_address = coStrGet(coVectorGet(a2l, 3));
       coVectorAdd((co)coVectorGet(sw_object, AXIS_PTS_VECTOR_POS), a2l);
 
-      coMapAdd((co)coVectorGet(sw_object, AXIS_PTS_NAME_MAP_POS), axis_pts_name, a2l);
+      coHashMapAdd((co)coVectorGet(sw_object, AXIS_PTS_NAME_MAP_POS), axis_pts_name, a2l);
 		
       coMapAdd((co)coVectorGet(sw_object, ADDRESS_MAP_POS), axis_pts_address, a2l);
     }
-    else if ( strcmp( coStrGet(element), "FUNCTION" ) == 0 )
+    else if ( isKeyword( keyword, bis->function, "FUNCTION" ) )
 	{
 		bis->function_name = coStrGet(coVectorGet(a2l, 1));	// we are inside a function, remember the function name
 		bis->function_object = a2l;
 		coVectorAdd((co)coVectorGet(sw_object, FUNCTION_VECTOR_POS), a2l);
 
-		coMapAdd((co)coVectorGet(sw_object, FUNCTION_NAME_MAP_POS), bis->function_name, a2l);
+		coHashMapAdd((co)coVectorGet(sw_object, FUNCTION_NAME_MAP_POS), bis->function_name, a2l);
 		
 		
 		
 	}
-    else if ( strcmp( coStrGet(element), "SUB_FUNCTION" ) == 0 )
+    else if ( isKeyword( keyword, bis->sub_function, "SUB_FUNCTION" ) )
 	{
 	  if ( bis->function_object != NULL )
 	  {
@@ -189,13 +245,13 @@ void buildIndexTables(cco sw_object, cco a2l, struct build_index_struct *bis)
 			if ( coIsStr(element) )
 			{
 				// the sub function might already exist in the map, but this shouldn't happen because a function should have only one parent
-				coMapAdd((co)coVectorGet(sw_object, PARENT_FUNCTION_MAP_POS), coStrGet(element), bis->function_object);
+				coHashMapAdd((co)coVectorGet(sw_object, PARENT_FUNCTION_MAP_POS), coStrGet(element), bis->function_object);
 			}
 		  }
 		  return; 	// no need to continue to the loop below, because there are no further sub elements
 	  }
 	}	
-    else if ( strcmp( coStrGet(element), "DEF_CHARACTERISTIC" ) == 0 )
+    else if ( isKeyword( keyword, bis->def_characteristic, "DEF_CHARACTERISTIC" ) )
 	{
 	  if ( bis->function_object != NULL )
 	  {
@@ -205,7 +261,7 @@ void buildIndexTables(cco sw_object, cco a2l, struct build_index_struct *bis)
 			if ( coIsStr(element) )
 			{
 				// the DEF_CHARACTERISTIC might already exist in the map, but this shouldn't happen because there should be only one function possible as per A2L
-				coMapAdd((co)coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS), coStrGet(element), bis->function_object);
+				coHashMapAdd((co)coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS), coStrGet(element), bis->function_object);
 			}
 		  }
 		  return; 	// no need to continue to the loop below, because there are no further sub elements
@@ -242,7 +298,7 @@ static int buildFunctionDefCharacteristicMapCB(cco o, long idx, const char *key,
 	cco axis_pts_map = coVectorGet(sw_object, AXIS_PTS_NAME_MAP_POS);
 	
 	/* try to see, whether the key is a CHARACTERISTIC */
-	cco characteristic_rec = coMapGet(characteristic_map, key);	// might be NULL if key is not a CHARACTERISTIC
+	cco characteristic_rec = coHashMapGet(characteristic_map, key);	// might be NULL if key is not a CHARACTERISTIC
 	
 	assert(map != NULL);	// this should not be NULL, because it was added before in step 1
 
@@ -252,7 +308,7 @@ static int buildFunctionDefCharacteristicMapCB(cco o, long idx, const char *key,
 	}
 	else	// otherwise it is an AXIS_PTS
 	{
-		cco axis_pts_rec = coMapGet(axis_pts_map, key);	// might be NULL
+		cco axis_pts_rec = coHashMapGet(axis_pts_map, key);	// might be NULL
 		if ( axis_pts_rec != NULL )
 		{
 			coMapAdd(map, key, axis_pts_rec);
@@ -265,7 +321,7 @@ static int buildFunctionDefCharacteristicMapCB(cco o, long idx, const char *key,
 	return 1;		// all good, continue
 }
 
-/* 
+/*
 	calculate FUNCTION_DEF_CHARACTERISTIC_MAP_POS 
 	This must be called after call to buildIndexTables()
 	
@@ -297,7 +353,7 @@ void buildFunctionDefCharacteristicMap(cco sw_object)
 	//		Step 2.2 search for the CHARACTERISTIC / AXIS_PTS record in CHARACTERISTIC_NAME_MAP_POS / AXIS_PTS_NAME_MAP_POS
 	//		Step 2.3 append the CHARACTERISTIC / AXIS_PTS record to FUNCTION_VECTOR_POS key=CHARACTERISTIC / AXIS_PTS, value = CHARACTERISTIC / AXIS_PTS record
 	
-	coMapForEach(coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS), buildFunctionDefCharacteristicMapCB, (void *)sw_object);
+	coHashMapForEach(coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS), buildFunctionDefCharacteristicMapCB, (void *)sw_object);
 }
 
 
@@ -578,39 +634,8 @@ int getRecordLayoutSize(cco record_layout_rec, long *fixed_size, long *dynamic_s
 
 unsigned char *getMemoryArea(cco sw_object, size_t address, size_t length)
 {
-  char addr_as_hex[10];
-  long pos;
-  cco memory_block;
-  size_t memory_adr;
-  size_t memory_len;
-  size_t delta;
-  unsigned char *ptr;
-  
-  sprintf(addr_as_hex, "%08zX", address);
-  pos = coVectorPredecessorBinarySearch(coVectorGet(sw_object, DATA_VECTOR_POS), addr_as_hex); 
-  if ( pos < 0 )
-  {
-    return NULL;
-  }
-  memory_block = coVectorGet(coVectorGet(sw_object, DATA_VECTOR_POS), pos);
-  memory_adr = strtoll(coStrGet(coVectorGet(memory_block, 0)), NULL, 16);
-  memory_len = coMemSize(coVectorGet(memory_block, 1));
-  delta = address - memory_adr;
-  
-
-  if ( delta+length >= memory_len )
-  {
-    //printf("getMemoryArea: requested memory not found\n");
-    return NULL;
-  }
-
-  
-  ptr = (unsigned char *)coMemGet(coVectorGet(memory_block, 1));
-  ptr += delta;
-
-  //printf("getMemoryArea(%08zX,%08zX) -%ld-> %08zX-%08zX, delta=%08zX, first byte=%02X\n", address, length, pos, memory_adr, memory_adr+memory_len-1, delta, (unsigned)*ptr);
-  
-  return ptr;
+  // NULL if the requested memory is not found
+  return (unsigned char *)coMemImageGet(coVectorGet(sw_object, DATA_MAP_POS), address, length);
 }
 
 char *getMemoryAreaString(cco sw_object, size_t address, size_t length)
@@ -646,7 +671,7 @@ int getCharacteristicAxisPtsMemoryArea(cco sw_object, cco characteristic_or_axis
 	const char *element_type = coStrGet(coVectorGet(characteristic_or_axis_pts, 0)); // either AXIS_PTS or CHARACTERISTIC
 	const char *record_layout_name = coStrGet(coVectorGet(characteristic_or_axis_pts, 5)); // record layout name is at the same position for both 
 	const char *address_string = coStrGet(coVectorGet(characteristic_or_axis_pts, 4)); //  
-	cco record_layout_rec = coMapGet((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), record_layout_name);	// find the record layout element
+	cco record_layout_rec = coHashMapGet((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), record_layout_name);	// find the record layout element
 	long factor = getCharacteristicMeasurementAxisPTSDataMultiplicator(characteristic_or_axis_pts);  // get the object multiplication factor
 	long fixed_size;
 	long dynamic_size;
@@ -680,7 +705,7 @@ int showAddressListCB(cco o, long idx, const char *key, cco characteristic_or_ax
 	const char *record_layout_name = coStrGet(coVectorGet(characteristic_or_axis_pts, 5)); // record layout name is at the same position for both CHARACTERISTIC and AXIS_PTS
 	long fixed_size;
 	long dynamic_size;
-	cco record_layout_rec = coMapGet((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), record_layout_name);
+	cco record_layout_rec = coHashMapGet((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), record_layout_name);
 	
 	long factor = getCharacteristicMeasurementAxisPTSDataMultiplicator(characteristic_or_axis_pts);
 	int is_supported = getRecordLayoutSize(record_layout_rec, &fixed_size, &dynamic_size);
@@ -733,7 +758,7 @@ void showCharacteristic(cco sw_object, cco characteristic_rec)
   cco compu_method_rec = NULL;
   
   if ( strcmp( compu_method, "NO_COMPU_METHOD" ) != 0 )
-	compu_method_rec = coMapGet(coVectorGet(sw_object, COMPU_METHOD_MAP_POS), compu_method);
+	compu_method_rec = coHashMapGet(coVectorGet(sw_object, COMPU_METHOD_MAP_POS), compu_method);
 
   if ( multiplicator > 1 )
 	printf("CHARACTERISTIC %-50s %-10s %-24s %-30s %ld\n",
@@ -784,7 +809,7 @@ void showAllASCIICharacteristic(cco sw_object)
 			const char *record_layout_name = coStrGet(coVectorGet(characteristic_rec, 5)); // record layout name 
 			long fixed_size;
 			long dynamic_size;
-			cco record_layout_rec = coMapGet((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), record_layout_name);
+			cco record_layout_rec = coHashMapGet((co)coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS), record_layout_name);
 			long factor = getCharacteristicMeasurementAxisPTSDataMultiplicator(characteristic_rec);
 			int is_supported = getRecordLayoutSize(record_layout_rec, &fixed_size, &dynamic_size);
 			if ( is_supported )
@@ -815,7 +840,7 @@ co getS19Object(const char *s19)
         return perror(s19), NULL;
   if ( is_verbose ) printf("Reading S19 '%s' started\n", s19);
   t1 = getEpochMilliseconds();
-  o = coReadS19ByFP(fp);
+  o = coReadS19ByFPParallel(fp, a2l_thread_cnt, CO_READ_MEM_IMAGE | (is_s19_checksum ? CO_READ_CHECKSUM : 0));
   t2 = getEpochMilliseconds();
   if ( is_verbose ) printf("Reading S19 '%s' done, milliseconds=%lld\n", s19, t2-t1);
   fclose(fp);	  
@@ -827,20 +852,207 @@ void *getS19Thread( void *ptr )
   return (void *)getS19Object((const char *)ptr);
 }
 
+/*===================================================================*/
+/* snapshot cache */
+/*===================================================================*/
+
+/*
+  The a2l tree and the s19 data are stored in a binary snapshot file (see coWriteBinary()) inside cache_dir.
+  The snapshot is a vector with three elements:
+    [0]: cache key: build of a2l_info, name, size and modification time of the a2l and the s19 file,
+         s19 checksum verification (-checksum)
+    [1]: a2l tree
+    [2]: s19 memory image, NULL if no s19 file is used
+  The cache key is also stored in a separate small key file. The key file is
+  read and compared first, so that an outdated snapshot is not loaded into the arena.
+  The snapshot is only used, if the cache key matches the current files.
+  A snapshot is not written if the s19 file can't be read, so that the read
+  error is reported again by the next call.
+*/
+
+/* the binary format and the a2l tree might change with each build */
+const char cache_version[] = "a2l_info snapshot 1, " __DATE__ " " __TIME__;
+
+/* returns NULL if any of the files doesn't exist */
+co getCacheKey(const char *a2l, const char *s19)
+{
+  struct stat st;
+  const char *name[2];
+  int i;
+  co key = coNewVector(CO_FREE_VALS);
+  if ( key == NULL )
+    return NULL;
+  name[0] = a2l;
+  name[1] = s19;
+  coVectorAdd(key, coNewStr(CO_NONE, cache_version));
+  for( i = 0; i < 2; i++ )
+  {
+    if ( name[i] == NULL )
+    {
+      coVectorAdd(key, coNewStr(CO_NONE, ""));
+      continue;
+    }
+    if ( stat(name[i], &st) != 0 )
+      return coDelete(key), NULL;
+    coVectorAdd(key, coNewStr(CO_STRDUP, name[i]));
+    coVectorAdd(key, coNewDbl((double)st.st_size));
+    coVectorAdd(key, coNewDbl((double)st.st_mtime));
+  }
+  coVectorAdd(key, coNewDbl(s19 != NULL && is_s19_checksum ? 1.0 : 0.0));	// a snapshot from an unchecked s19 file must not be used with -checksum
+  return key;
+}
+
+int isSameCacheKey(cco a, cco b)
+{
+  long i, cnt;
+  cco x, y;
+  if ( !coIsVector(a) || !coIsVector(b) )
+    return 0;
+  cnt = coVectorSize(a);
+  if ( cnt != coVectorSize(b) )
+    return 0;
+  for( i = 0; i < cnt; i++ )
+  {
+    x = coVectorGet(a, i);
+    y = coVectorGet(b, i);
+    if ( coIsStr(x) && coIsStr(y) && strcmp(coStrGet(x), coStrGet(y)) == 0 )
+      continue;
+    if ( coIsDbl(x) && coIsDbl(y) && coDblGet(x) == coDblGet(y) )
+      continue;
+    return 0;
+  }
+  return 1;
+}
 
-co getSWObject(const char *a2l, const char *s19)
+/*
+  the name of the snapshot and key file is derived from the names of the a2l and the s19 file,
+  ext is ".bin" or ".key"
+*/
+void getCacheFileName(char *buf, size_t size, cco key, const char *ext)
+{
+  unsigned long h = 2166136261UL; // FNV-1a
+  const char *s;
+  long i;
+  for( i = 1; i < coVectorSize(key); i++ )	// skip the version, a new build overwrites the old files
+  {
+    if ( !coIsStr(coVectorGet(key, i)) )
+      continue;
+    for( s = coStrGet(coVectorGet(key, i)); *s != '\0'; s++ )
+      h = ((h ^ (unsigned char)*s) * 16777619UL) & 0x0ffffffffUL;
+    h = ((h ^ '\n') * 16777619UL) & 0x0ffffffffUL;
+  }
+  snprintf(buf, size, "%s/a2l_info_%08lx%s", cache_dir, h, ext);
+}
+
+/* returns 1 if the key file exists and matches key, the stored key is not read into the arena */
+int isValidSWCacheKey(cco key)
+{
+  char name[1024];
+  FILE *fp;
+  co stored_key;
+  int is_same;
+  getCacheFileName(name, sizeof(name), key, ".key");
+  fp = fopen(name, "rb");
+  if ( fp == NULL )
+    return 0;
+  stored_key = coReadBinaryByFP(fp);
+  fclose(fp);
+  is_same = isSameCacheKey(stored_key, key);
+  coDelete(stored_key);
+  if ( is_verbose && is_same == 0 ) printf("Cache '%s' outdated\n", name);
+  return is_same;
+}
+
+/* returns the snapshot vector (inside the arena) or NULL, is_s19: the snapshot must contain the s19 data */
+co readSWCache(cco key, int is_s19, coArena arena)
+{
+  char name[1024];
+  FILE *fp;
+  co cache;
+  if ( isValidSWCacheKey(key) == 0 )
+    return NULL;
+  getCacheFileName(name, sizeof(name), key, ".bin");
+  fp = fopen(name, "rb");
+  if ( fp == NULL )
+    return NULL;
+  cache = coReadBinaryByFPWithArena(fp, arena);
+  fclose(fp);
+  if ( !coIsVector(cache) || coVectorSize(cache) != 3 || !isSameCacheKey(coVectorGet(cache, 0), key) || !coIsVector(coVectorGet(cache, 1))
+       || ( is_s19 ? !coIsMemImage(coVectorGet(cache, 2)) : coVectorGet(cache, 2) != NULL ) )
+  {
+    // snapshot was replaced after the key check or doesn't contain the s19 data
+    if ( is_verbose ) printf("Cache '%s' outdated\n", name);
+    return NULL;		// memory is released together with the arena
+  }
+  return cache;
+}
+
+/* write o into the file name, returns 0 for error */
+int writeCacheFile(const char *name, cco o)
+{
+  char tmp_name[1024+8];
+  FILE *fp;
+  int is_ok;
+  snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", name);		// parallel processes must not see an incomplete file
+  fp = fopen(tmp_name, "wb");
+  if ( fp == NULL )
+    return perror(tmp_name), 0;
+  is_ok = coWriteBinary(o, fp);
+  if ( fclose(fp) != 0 )
+    is_ok = 0;
+  remove(name);		// rename() might fail on windows if name exists
+  if ( is_ok == 0 || rename(tmp_name, name) != 0 )
+    return perror(name), remove(tmp_name), 0;
+  return 1;
+}
+
+void writeSWCache(cco key, cco a2l_tree, cco s19_object)
+{
+  char name[1024];
+  char key_name[1024];
+  int is_ok;
+  co cache = coNewVector(CO_NONE);	// references only
+  if ( cache == NULL )
+    return;
+  coVectorAdd(cache, key);
+  coVectorAdd(cache, a2l_tree);
+  coVectorAdd(cache, s19_object);
+  getCacheFileName(name, sizeof(name), key, ".bin");
+  getCacheFileName(key_name, sizeof(key_name), key, ".key");
+  remove(key_name);		// the key file is written after the snapshot is complete
+  is_ok = writeCacheFile(name, cache) && writeCacheFile(key_name, key);
+  coDelete(cache);
+  if ( is_ok && is_verbose ) printf("Cache '%s' written\n", name);
+}
+
+
+co getSWObject(const char *a2l, const char *s19, coArena arena, co pool)
 {
   FILE *fp;
   long long int t0, t1, t2;
   co sw_object = createSWObject();
   co s19_object = NULL;  // s19 object, it will be added to sw_object later
+  co cache_key = NULL;
+  co cache = NULL;	// snapshot vector from cache_dir
   struct build_index_struct bis;	// local data for tbe build index procedure (to make it MT safe)
   
 #ifdef USE_PTHREAD
   pthread_t s19_thread;
   int s19_thread_create_result;
+#endif  
 
-  if ( s19 != NULL )    // if s19 is required, then read this in parallel to the a2l
+  if ( cache_dir != NULL && a2l != NULL )
+  {
+    t0 = getEpochMilliseconds();  
+    cache_key = getCacheKey(a2l, s19);
+    if ( cache_key != NULL )
+      cache = readSWCache(cache_key, s19 != NULL, arena);
+    t1 = getEpochMilliseconds();
+    if ( is_verbose && cache != NULL ) printf("Reading A2L/S19 '%s' from cache done, milliseconds=%lld\n", a2l, t1-t0);
+  }
+  
+#ifdef USE_PTHREAD
+  if ( s19 != NULL && cache == NULL )    // if s19 is required, then read this in parallel to the a2l
   {
     s19_thread_create_result = pthread_create( &s19_thread, NULL, getS19Thread, (void*)(s19));
     if ( s19_thread_create_result != 0 )
@@ -852,19 +1064,37 @@ co getSWObject(const char *a2l, const char *s19)
   if ( a2l == NULL )
     return coDelete(sw_object), NULL;
 
-  t0 = getEpochMilliseconds();  
-  
-  /* read a2l file */
-  fp = fopen(a2l, "rb");  // we need to read binary so that the CR/LF conversion is suppressed on windows
-  if ( fp == NULL )
-    return perror(a2l), coDelete(sw_object), NULL;
-  if ( is_verbose ) printf("Reading A2L '%s' started\n", a2l);
-  coVectorAdd(sw_object, coReadA2LByFP(fp));
-  t1 = getEpochMilliseconds();
-  if ( is_verbose ) printf("Reading A2L '%s' done, milliseconds=%lld\n", a2l, t1-t0);
-  fclose(fp);
+  if ( cache != NULL )
+  {
+    coVectorAdd(sw_object, coVectorGet(cache, 1));	// the a2l tree is released together with the arena
+    s19_object = (co)coVectorGet(cache, 2);		// arena memory image, not released by coDelete(sw_object)
+    pool = NULL;	// the a2l tree from the cache doesn't use the pool
+  }
+  else
+  {
+    t0 = getEpochMilliseconds();  
+    
+    /* read a2l file */
+    fp = fopen(a2l, "rb");  // we need to read binary so that the CR/LF conversion is suppressed on windows
+    if ( fp == NULL )
+      return perror(a2l), coDelete(cache_key), coDelete(sw_object), NULL;
+    if ( is_verbose ) printf("Reading A2L '%s' started\n", a2l);
+    if ( a2l_thread_cnt > 1 )
+      coVectorAdd(sw_object, coReadA2LByFPParallel(fp, pool, a2l_thread_cnt));	// malloc'ed a2l tree, released together with sw_object, the tokens are stored in the pool
+    else
+      coVectorAdd(sw_object, coReadA2LByFPWithPool(fp, arena, pool));	// the a2l tree is released together with the arena and the pool
+    t1 = getEpochMilliseconds();
+    if ( is_verbose ) printf("Reading A2L '%s' done, milliseconds=%lld\n", a2l, t1-t0);
+    if ( is_verbose && pool != NULL )
+    {
+      printf("A2L string pool ");
+      coPrint(pool);
+      puts("");
+    }
+    fclose(fp);
+  }
 
-  if ( s19 != NULL )
+  if ( s19 != NULL && cache == NULL )
   {
 #ifdef USE_PTHREAD
     // With pthread, wait for the parallel s19 data
@@ -875,29 +1105,31 @@ co getSWObject(const char *a2l, const char *s19)
 #endif
   }
   
+  if ( cache_key != NULL && cache == NULL && coVectorGet(sw_object, A2L_POS) != NULL && ( s19 == NULL || s19_object != NULL ) )
+    writeSWCache(cache_key, coVectorGet(sw_object, A2L_POS), s19_object);
+  coDelete(cache_key);
+  
   /* attach the s19 object to the sw_object */
   if ( s19_object != NULL )
   {
           assert(coVectorSize(sw_object) == DATA_MAP_POS);
-	  coVectorAdd(sw_object, s19_object);
-	  coVectorAdd(sw_object, coNewVectorByMap(coVectorGet(sw_object, DATA_MAP_POS)));	// build the sorted vector from the data map file
+	  coVectorAdd(sw_object, s19_object);	// memory blocks are sorted by address, no extra vector required
 	  if ( is_verbose ) 
 	  {
-		  coPrint(coVectorGet(sw_object, DATA_VECTOR_POS));
+		  coPrint(coVectorGet(sw_object, DATA_MAP_POS));
 		  puts("");
 	  }
   }
   else
   {
-          // s19 not available, add some dummy entries
-	  coVectorAdd(sw_object, coNewMap(CO_NONE));	// add dummy entry for the s19 data
-	  coVectorAdd(sw_object, coNewVector(CO_NONE));  // add a dummy vector to s19 data
+          // s19 not available, add a dummy entry
+	  coVectorAdd(sw_object, coNewMemImage());	// add empty memory image for the s19 data
   }
 
   /* build the remaining index tables */
   if ( is_verbose ) printf("Building A2L index tables '%s' started\n", a2l);
   t1 = getEpochMilliseconds();
-  buildIndexInit(&bis);
+  buildIndexInit(&bis, pool);
   buildIndexTables(sw_object, coVectorGet(sw_object, A2L_POS), &bis);
   buildFunctionDefCharacteristicMap(sw_object); 	// build FUNCTION_DEF_CHARACTERISTIC_MAP_POS, based on the results from buildIndexTables()
   t2 = getEpochMilliseconds();  
@@ -909,7 +1141,9 @@ co getSWObject(const char *a2l, const char *s19)
 void *getSWListThread( void *ptr )
 {
 	int idx = *(int *)ptr;
-	sw_object_list[idx] = getSWObject(a2l_file_name_list[idx], s19_file_name_list[idx]);
+	sw_arena_list[idx] = coNewArena(0);
+	sw_pool_list[idx] = coNewStrPool();
+	sw_object_list[idx] = getSWObject(a2l_file_name_list[idx], s19_file_name_list[idx], sw_arena_list[idx], sw_pool_list[idx]);
 	return NULL;
 }
        
@@ -977,7 +1211,7 @@ const char *getFullFunctionName(cco sw_object, cco function)
 		name = coStrGet(coVectorGet(f, 1));
 		name_list[cnt] = name;
 		cnt++;
-		f = coMapGet(m, name);
+		f = coHashMapGet(m, name);
 		if ( f == NULL )
 			break;
 	}
@@ -1206,7 +1440,7 @@ int getCharacteristicAxisPtsDifference(cco sw_list, const char *characteristic_n
 			long long int first_address;
 			long first_size;
 			int first_is_supported = getCharacteristicAxisPtsMemoryArea(first_sw_object, first, &first_address, &first_size);
-			cco first_function = coMapGet(coVectorGet(first_sw_object, BELONGS_TO_FUNCTION_MAP_POS), characteristic_name); 
+			cco first_function = coHashMapGet(coVectorGet(first_sw_object, BELONGS_TO_FUNCTION_MAP_POS), characteristic_name); 
 
 			if ( first_is_supported == 0 )
 			{
@@ -1222,7 +1456,7 @@ int getCharacteristicAxisPtsDifference(cco sw_list, const char *characteristic_n
 						// first and second are not NULL
 						cco second_sw_object = coVectorGet(sw_list, j);
 						//assert(second_sw_object != NULL);
-						cco second_function = coMapGet(coVectorGet(second_sw_object, BELONGS_TO_FUNCTION_MAP_POS), characteristic_name); 
+						cco second_function = coHashMapGet(coVectorGet(second_sw_object, BELONGS_TO_FUNCTION_MAP_POS), characteristic_name); 
 						
 						long long int second_address;
 						long second_size;
@@ -1289,7 +1523,7 @@ int showAllCharacteristicDifferenceMapCB(cco o, long idx, const char *key, cco v
 			if ( function_path_name == NULL )
 			{
 				cco m = coVectorGet(first_sw_object, BELONGS_TO_FUNCTION_MAP_POS);
-				cco function = coMapGet(m, key);
+				cco function = coHashMapGet(m, key);
 				if ( function != NULL )
 				{
 					function_path_name = getFullFunctionName(first_sw_object, function);
@@ -1437,7 +1671,7 @@ void showFunctionDifferenceList(cco all_function_def_characteristic_map, cco sw_
 				sw_object = coVectorGet(sw_list, i);
 				function_version_string = "";
 				function_name_map = coVectorGet(sw_object, FUNCTION_NAME_MAP_POS);
-				function_rec = coMapGet(function_name_map, function_name);
+				function_rec = coHashMapGet(function_name_map, function_name);
 				if ( function_rec != NULL )
 				{
 					function_version_index = getVectorIndexByString(function_rec, "FUNCTION_VERSION");
@@ -1454,7 +1688,7 @@ void showFunctionDifferenceList(cco all_function_def_characteristic_map, cco sw_
 			{
 				sw_object = coVectorGet(sw_list, i);
 				function_name_map = coVectorGet(sw_object, FUNCTION_NAME_MAP_POS);
-				function_rec = coMapGet(function_name_map, function_name);
+				function_rec = coHashMapGet(function_name_map, function_name);
 				if ( function_rec == NULL )
 				{
 					printf("[] ");
@@ -1488,15 +1722,15 @@ void showFunctionDifferenceList(cco all_function_def_characteristic_map, cco sw_
 						sw_object = coVectorGet(sw_list, i);
 						is_other_function = 0;
 						belongs_to_function_map = coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS);
-						belongs_to_function_rec = coMapGet(belongs_to_function_map, characteristic_axis_pts_name);
+						belongs_to_function_rec = coHashMapGet(belongs_to_function_map, characteristic_axis_pts_name);
 						if ( belongs_to_function_rec == NULL )
 							is_other_function = 1;
 						else if ( strcmp(function_name, coStrGet(coVectorGet(belongs_to_function_rec, 1))) != 0 )
 							is_other_function = 1;
 						characteristic_name_map = coVectorGet(sw_object, CHARACTERISTIC_NAME_MAP_POS);
 						axis_pts_name_map = coVectorGet(sw_object, AXIS_PTS_NAME_MAP_POS);
-						characteristic_rec = coMapGet(characteristic_name_map, characteristic_axis_pts_name);
-						axis_pts_rec = coMapGet(axis_pts_name_map, characteristic_axis_pts_name);
+						characteristic_rec = coHashMapGet(characteristic_name_map, characteristic_axis_pts_name);
+						axis_pts_rec = coHashMapGet(axis_pts_name_map, characteristic_axis_pts_name);
 						if ( characteristic_rec != NULL )
 						{
 							if ( is_other_function )
@@ -1809,7 +2043,7 @@ void showFunctionJSONDifference(cco all_function_def_characteristic_map, cco sw_
 				outJSON("[");
 				for(;;)
 				{
-					tmp = coMapGet(parent_function_map, f);
+					tmp = coHashMapGet(parent_function_map, f);
 					if ( tmp == NULL )
 						break;
 					if ( f != function_name )
@@ -1837,7 +2071,7 @@ void showFunctionJSONDifference(cco all_function_def_characteristic_map, cco sw_
 				sw_object = coVectorGet(sw_list, i);
 				function_version_string = "";
 				function_name_map = coVectorGet(sw_object, FUNCTION_NAME_MAP_POS);
-				function_rec = coMapGet(function_name_map, function_name);
+				function_rec = coHashMapGet(function_name_map, function_name);
 				if ( function_rec != NULL )
 				{
 					function_version_index = getVectorIndexByString(function_rec, "FUNCTION_VERSION");
@@ -1866,7 +2100,7 @@ void showFunctionJSONDifference(cco all_function_def_characteristic_map, cco sw_
 					outJSON(",");
 				sw_object = coVectorGet(sw_list, i);
 				function_name_map = coVectorGet(sw_object, FUNCTION_NAME_MAP_POS);
-				function_rec = coMapGet(function_name_map, function_name);
+				function_rec = coHashMapGet(function_name_map, function_name);
 				if ( function_rec == NULL )
 				{
 					function_desc_string = "";
@@ -1909,15 +2143,15 @@ void showFunctionJSONDifference(cco all_function_def_characteristic_map, cco sw_
 						sw_object = coVectorGet(sw_list, i);
 						is_other_function = 0;
 						belongs_to_function_map = coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS);
-						belongs_to_function_rec = coMapGet(belongs_to_function_map, characteristic_axis_pts_name);
+						belongs_to_function_rec = coHashMapGet(belongs_to_function_map, characteristic_axis_pts_name);
 						if ( belongs_to_function_rec == NULL )
 							is_other_function = 1;
 						else if ( strcmp(function_name, coStrGet(coVectorGet(belongs_to_function_rec, 1))) != 0 )
 							is_other_function = 1;
 						characteristic_name_map = coVectorGet(sw_object, CHARACTERISTIC_NAME_MAP_POS);
 						axis_pts_name_map = coVectorGet(sw_object, AXIS_PTS_NAME_MAP_POS);
-						characteristic_rec = coMapGet(characteristic_name_map, characteristic_axis_pts_name);
-						axis_pts_rec = coMapGet(axis_pts_name_map, characteristic_axis_pts_name);
+						characteristic_rec = coHashMapGet(characteristic_name_map, characteristic_axis_pts_name);
+						axis_pts_rec = coHashMapGet(axis_pts_name_map, characteristic_axis_pts_name);
 						if ( characteristic_rec != NULL )
 						{
 							if ( is_other_function )
@@ -2000,6 +2234,9 @@ void help(void)
   puts("-cjsondiff    Similar to -diff, but use JSON format (requires multipe a2l/s19 pairs)");
   puts("-fnjsondiff   Similar to -fndiff, but use JSON format (requires multipe a2l/s19 pairs)");
   puts("-json <file>  Output file for '-cjsondiff' and '-fnjsondiff'");
+  puts("-threads <n>  Number of threads for reading a single A2L or S19 file (default 1)");
+  puts("-cache <dir>  Store a binary snapshot of each a2l/s19 pair in <dir> and use it in the next run");
+  puts("-checksum     Verify the checksum of each S19 record");
   
 }
 
@@ -2052,6 +2289,33 @@ int parse_args(int argc, char **argv)
 	  is_functionjsondiff = 1;
       argv++;
     }
+	else if ( strcmp(*argv, "-threads" ) == 0 )
+	{
+       argv++;
+	   if ( *argv == NULL )
+	   {
+		  fprintf(stderr, "Missing argument for -threads\n");
+		  exit(1);
+	   }
+	   a2l_thread_cnt = atoi(*argv);
+	   argv++;
+	}
+	else if ( strcmp(*argv, "-checksum" ) == 0 )
+	{
+	   is_s19_checksum = 1;
+	   argv++;
+	}
+	else if ( strcmp(*argv, "-cache" ) == 0 )
+	{
+       argv++;
+	   if ( *argv == NULL )
+	   {
+		  fprintf(stderr, "Missing argument for -cache\n");
+		  exit(1);
+	   }
+	   cache_dir = *argv;
+	   argv++;
+	}
 	else if ( strcmp(*argv, "-json" ) == 0 )
 	{
        argv++;
@@ -2135,19 +2399,19 @@ int main(int argc, char **argv)
 	  if ( is_verbose ) 
 	  {
 		  printf("%s:\n", a2l_file_name_list[i]);
-		  printf("  COMPU_METHOD cnt=%ld\n", coMapSize(coVectorGet(sw_object, COMPU_METHOD_MAP_POS)));
-		  printf("  COMPU_VTAB cnt=%ld\n", coMapSize(coVectorGet(sw_object, COMPU_VTAB_MAP_POS)));
-		  printf("  RECORD_LAYOUT cnt=%ld\n", coMapSize(coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS)));
+		  printf("  COMPU_METHOD cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, COMPU_METHOD_MAP_POS)));
+		  printf("  COMPU_VTAB cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, COMPU_VTAB_MAP_POS)));
+		  printf("  RECORD_LAYOUT cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, RECORD_LAYOUT_MAP_POS)));
 		  printf("  CHARACTERISTIC Vector cnt=%ld\n", coVectorSize(coVectorGet(sw_object, CHARACTERISTIC_VECTOR_POS)));
-		  printf("  CHARACTERISTIC Name Map cnt=%ld\n", coMapSize(coVectorGet(sw_object, CHARACTERISTIC_NAME_MAP_POS)));
+		  printf("  CHARACTERISTIC Name Map cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, CHARACTERISTIC_NAME_MAP_POS)));
 		  printf("  AXIS_PTS Vector cnt=%ld\n", coVectorSize(coVectorGet(sw_object, AXIS_PTS_VECTOR_POS)));
-		  printf("  AXIS_PTS Name Map cnt=%ld\n", coMapSize(coVectorGet(sw_object, AXIS_PTS_NAME_MAP_POS)));
+		  printf("  AXIS_PTS Name Map cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, AXIS_PTS_NAME_MAP_POS)));
 		  printf("  Address Map cnt=%ld\n", coMapSize(coVectorGet(sw_object, ADDRESS_MAP_POS)));
 		  printf("  FUNCTION Vector cnt=%ld\n", coVectorSize(coVectorGet(sw_object, FUNCTION_VECTOR_POS)));
-		  printf("  FUNCTION Name Map cnt=%ld\n", coMapSize(coVectorGet(sw_object, FUNCTION_NAME_MAP_POS)));
+		  printf("  FUNCTION Name Map cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, FUNCTION_NAME_MAP_POS)));
 		  printf("  FUNCTION CHARACTERISTIC/AXIS_PTS Map cnt=%ld\n", coMapSize(coVectorGet(sw_object, FUNCTION_DEF_CHARACTERISTIC_MAP_POS)));
-		  printf("  Parent Function Map cnt=%ld\n", coMapSize(coVectorGet(sw_object, PARENT_FUNCTION_MAP_POS)));
-		  printf("  Belongs to Function Map cnt=%ld\n", coMapSize(coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS)));
+		  printf("  Parent Function Map cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, PARENT_FUNCTION_MAP_POS)));
+		  printf("  Belongs to Function Map cnt=%ld\n", coHashMapSize(coVectorGet(sw_object, BELONGS_TO_FUNCTION_MAP_POS)));
 		  
 	  }
 	  if ( is_characteristic_address_list )
@@ -2184,10 +2448,14 @@ int main(int argc, char **argv)
 
 #ifndef NDEBUG  
   coDelete(sw_list);     // delete all co objects, this is time consuming, so don't do this for the final release
+  for( i = 0; i < sw_pair_cnt; i++ )
+	  coDeleteArena(sw_arena_list[i]);	// delete the a2l trees
+  for( i = 0; i < sw_pair_cnt; i++ )
+	  coDelete(sw_pool_list[i]);	// delete the interned a2l tokens
 #endif
 
 
   return 0;
 }
   
-  
\ No newline at end of file
+  
\ No newline at end of file
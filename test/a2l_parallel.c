@@ -0,0 +1,245 @@
+/*
+
+	a2l_parallel
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	regression test for the parallel A2L parser:
+	each file is read with coReadA2LByFP() and with
+	coReadA2LByFPParallelWithInfo() (2 up to the given number of threads),
+	without pool and with a string pool. All trees must be identical, the
+	parallel parser must not fall back to the serial reader and all tokens
+	must be stored in the string pool. A hash map pool must use the serial
+	reader.
+	Without file arguments, a generated A2L file (with and without UTF-8 BOM)
+	is used. It contains comments, strings with escaped quotes and "/begin",
+	"/end" inside comments and strings.
+
+	a2l_parallel [-t threads] [file.a2l ...]
+
+	Errorlevel:
+		0		all trees are identical
+		1		some trees are different
+		2		some error has happend (wrong commandline, read error)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define MEASUREMENT_CNT 500
+
+int thread_max = 8;
+
+/* temporary A2L file, is_bom: start with the UTF-8 BOM */
+FILE *createA2L(int is_bom)
+{
+	FILE *fp = tmpfile();
+	int i;
+	if ( fp == NULL )
+		return NULL;
+	if ( is_bom )
+		fputs("\xef\xbb\xbf", fp);
+	fputs("/* generated by a2l_parallel, /begin MODULE inside a comment */\n", fp);
+	fputs("ASAP2_VERSION 1 71\n", fp);
+	fputs("/begin PROJECT p \"project \\\"p\\\"\"\n", fp);
+	fputs("  /begin HEADER \"header\" VERSION \"1.0\" /end HEADER\n", fp);
+	fputs("  /begin MODULE m \"module // not a comment\"\n", fp);
+	fputs("    // line comment /end MODULE\n", fp);
+	fputs("    /begin MOD_COMMON \"\" BYTE_ORDER MSB_LAST /end MOD_COMMON\n", fp);
+	for( i = 0; i < MEASUREMENT_CNT; i++ )
+	{
+		fprintf(fp, "    /begin MEASUREMENT m%d \"\\\"/end MEASUREMENT\\\" %d\" UBYTE NO_COMPU_METHOD 0 0 0 255\n", i, i);
+		fprintf(fp, "      /* block comment\n         /end MODULE */\n");
+		fprintf(fp, "      ECU_ADDRESS 0x%X\n", 0x1000 + i);
+		fprintf(fp, "      /begin IF_DATA XCP \"a\\\\b\" /begin DAQ %d /end DAQ /end IF_DATA\n", i);
+		fprintf(fp, "    /end MEASUREMENT\n");
+		if ( i % 3 == 0 )
+			fprintf(fp, "    /begin CHARACTERISTIC c%d \"\" VALUE 0x%X rl 0 cm 0 100 /end CHARACTERISTIC // c%d\n", i, 0x8000 + i, i);
+	}
+	fputs("  /end MODULE\n", fp);
+	fputs("  /begin MODULE second \"only the first MODULE is parsed in parallel\" /end MODULE\n", fp);
+	fputs("/end PROJECT\n", fp);
+	return fp;
+}
+
+/* read fp with thread_cnt threads, thread_cnt 1 uses the serial reader, pool can be NULL */
+co readA2L(FILE *fp, co pool, int thread_cnt, coParallelInfo *info)
+{
+	fseek(fp, 0, SEEK_SET);
+	if ( thread_cnt <= 1 )
+		return pool == NULL ? coReadA2LByFP(fp) : coReadA2LByFPWithPool(fp, NULL, pool);
+	return coReadA2LByFPParallelWithInfo(fp, pool, thread_cnt, info);
+}
+
+/* return 1 if all strings of the a2l tree are the string objects of the pool */
+int isPooled(cco o, co pool)
+{
+	long i;
+	if ( coIsStr(o) )
+		return coStrPoolAdd(pool, coStrGet(o), coSize(o)) == o;
+	for( i = 0; i < coVectorSize(o); i++ )
+		if ( isPooled(coVectorGet(o, i), pool) == 0 )
+			return 0;
+	return 1;
+}
+
+/* returns the number of errors */
+int compareA2L(FILE *fp, const char *name)
+{
+	int thread_cnt, is_pool;
+	int error_cnt = 0;
+	co reference;
+	co o;
+	co pool;
+	uint64_t start;
+	coParallelInfo info;
+
+	start = getEpochMilliseconds();
+	reference = readA2L(fp, NULL, 1, NULL);
+	if ( reference == NULL )
+	{
+		printf("read error: '%s'\n", name);
+		return 1;
+	}
+	printf("%s threads=1 milliseconds=%lu\n", name, (unsigned long)(getEpochMilliseconds()-start));
+	for( is_pool = 0; is_pool < 2; is_pool++ )
+		for( thread_cnt = 2; thread_cnt <= thread_max; thread_cnt++ )
+		{
+			pool = is_pool ? coNewStrPool() : NULL;
+			start = getEpochMilliseconds();
+			info.chunk_size = 0;
+			o = readA2L(fp, pool, thread_cnt, &info);
+			printf("%s threads=%d pool=%s milliseconds=%lu chunks=%ld", name, thread_cnt, is_pool ? "yes" : "no", (unsigned long)(getEpochMilliseconds()-start), info.chunk_cnt);
+			if ( info.thread_cnt < 2 )
+			{
+				printf(" serial reader used\n");
+				error_cnt++;
+			}
+			else if ( isEqual(reference, o) == 0 )
+			{
+				printf(" different tree\n");
+				error_cnt++;
+			}
+			else if ( pool != NULL && isPooled(o, pool) == 0 )
+			{
+				printf(" tokens are not in the pool\n");
+				error_cnt++;
+			}
+			else
+			{
+				printf(" ok\n");
+			}
+			coDelete(o);
+			coDelete(pool);
+		}
+	coDelete(reference);
+	return error_cnt;
+}
+
+/* check the content of the generated file */
+void testContent(FILE *fp)
+{
+	co a2l = readA2L(fp, NULL, 1, NULL);
+	cco project = coVectorGet(a2l, 3);		// [ASAP2_VERSION, 1, 71, [PROJECT, p, "...", [HEADER, ...], [MODULE, ...], [MODULE, ...]]]
+	cco module = coVectorGet(project, 4);
+	cco m0 = coVectorGet(module, 4);		// [MODULE, m, "...", [MOD_COMMON, ...], [MEASUREMENT, m0, ...], ...]
+	CHECK(coVectorSize(a2l) == 4 && coVectorSize(project) == 6);
+	CHECK(coIsVector(module) && strcmp(coStrGet(coVectorGet(module, 0)), "MODULE") == 0);
+	CHECK(coVectorSize(module) == 4 + MEASUREMENT_CNT + (MEASUREMENT_CNT+2)/3);
+	CHECK(coIsVector(m0) && strcmp(coStrGet(coVectorGet(m0, 2)), "\"\"/end MEASUREMENT\" 0\"") == 0);
+	coDelete(a2l);
+}
+
+/* a file without MODULE can't be split, coReadA2LByFP() is used */
+void testFallback(void)
+{
+	FILE *fp = tmpfile();
+	co ref, o, pool;
+	coParallelInfo info;
+	if ( fp == NULL )
+		return;
+	fputs("/begin PROJECT p \"\" /begin HEADER \"\" /end HEADER /end PROJECT\n", fp);
+	ref = readA2L(fp, NULL, 1, NULL);
+	info.chunk_size = 0;
+	o = readA2L(fp, NULL, 4, &info);
+	CHECK(ref != NULL && isEqual(ref, o));
+	CHECK(info.thread_cnt == 0);
+	coDelete(o);
+
+	pool = coNewStrPool();
+	o = readA2L(fp, pool, 4, &info);
+	CHECK(isEqual(ref, o) && isPooled(o, pool));
+	CHECK(info.thread_cnt == 0);
+	coDelete(o);
+	coDelete(pool);
+	coDelete(ref);
+	fclose(fp);
+}
+
+/* a hash map pool is not thread safe, the serial reader with the pool is used */
+void testHashMapPool(FILE *fp)
+{
+	co ref = readA2L(fp, NULL, 1, NULL);
+	co pool = coNewHashMap(CO_STRDUP);
+	co o;
+	coParallelInfo info;
+	info.chunk_size = 0;
+	o = readA2L(fp, pool, 4, &info);
+	CHECK(info.thread_cnt == 0);
+	CHECK(isEqual(ref, o));
+	CHECK(coHashMapExists(pool, "MEASUREMENT") && coHashMapExists(pool, "m499"));
+	coDelete(o);
+	coDelete(pool);
+	coDelete(ref);
+}
+
+int main(int argc, char **argv)
+{
+	FILE *fp;
+	int is_bom;
+
+	argv++;
+	if ( *argv != NULL && strcmp(*argv, "-t") == 0 && argv[1] != NULL )
+	{
+		thread_max = atoi(argv[1]);
+		argv += 2;
+	}
+	if ( thread_max < 2 || ( *argv != NULL && **argv == '-' ) )
+	{
+		printf("a2l_parallel [-t threads] [file.a2l ...]\n");
+		printf("  -t <n>    maximum number of threads (2.., default 8)\n");
+		return 2;
+	}
+
+	if ( *argv == NULL )
+	{
+		for( is_bom = 0; is_bom < 2; is_bom++ )
+		{
+			fp = createA2L(is_bom);
+			if ( fp == NULL )
+				return perror("tmpfile"), 2;
+			if ( is_bom == 0 )
+				testContent(fp), testHashMapPool(fp);
+			error_cnt += compareA2L(fp, is_bom ? "generated with BOM" : "generated");
+			fclose(fp);
+		}
+		testFallback();
+	}
+
+	while( *argv != NULL )
+	{
+		fp = fopen(*argv, "rb");
+		if ( fp == NULL )
+			return perror(*argv), 2;
+		error_cnt += compareA2L(fp, *argv);
+		fclose(fp);
+		argv++;
+	}
+	return error_cnt == 0 ? 0 : 1;
+}
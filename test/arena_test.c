@@ -0,0 +1,146 @@
+/*
+
+	arena_test
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	test for the arena allocator:
+	- coDelete() does not release objects with CO_ARENA
+	- mixed trees (heap objects with arena elements and clones of arena trees)
+	- coDeleteArena() releases the complete tree (use "make sanitize" to let
+	  the address sanitizer detect leaks and use after free)
+
+	arena_test [-r repeat]
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+const char *json = "[\"abc\", 1.5, true, {\"x\":\"def\", \"y\":[1, 2, 3]}, \"\\u00e4\"]";
+
+/* build a tree with all arena object types */
+co newArenaTree(coArena a)
+{
+	co v = coNewVectorWithArena(a, CO_FREE_VALS);
+	co m = coNewMapWithArena(a, CO_FREE_VALS|CO_STRDUP);
+	int i;
+	char key[16];
+	coVectorAdd(v, coNewStrWithArena(a, CO_STRDUP, "abc"));
+	coVectorAdd(v, coNewDblWithArena(a, 1.5));
+	coVectorAdd(v, coNewBoolWithArena(a, 1));
+	coVectorAdd(v, coNewMemWithArena(a, CO_STRDUP, "\001\002\003", 3));
+	for( i = 0; i < 100; i++ )	// requires growth of the arena map and vector
+	{
+		sprintf(key, "k%03d", i);
+		coMapAdd(m, key, coNewDblWithArena(a, i));
+		coVectorAdd(v, coNewDblWithArena(a, i));
+	}
+	coVectorAdd(v, m);
+	return v;
+}
+
+int isArenaTree(cco v)
+{
+	cco m;
+	if ( coIsVector(v) == 0 || coVectorSize(v) != 105 )
+		return 0;
+	if ( strcmp(coStrGet(coVectorGet(v, 0)), "abc") != 0 )
+		return 0;
+	if ( coDblGet(coVectorGet(v, 1)) != 1.5 || coBoolGet(coVectorGet(v, 2)) != 1 )
+		return 0;
+	if ( coMemSize(coVectorGet(v, 3)) != 3 || memcmp(coMemGet(coVectorGet(v, 3)), "\001\002\003", 3) != 0 )
+		return 0;
+	if ( coDblGet(coVectorGet(v, 103)) != 99.0 )
+		return 0;
+	m = coVectorGet(v, 104);
+	if ( coIsMap(m) == 0 || coMapSize(m) != 100 || coDblGet(coMapGet(m, "k042")) != 42.0 )
+		return 0;
+	return 1;
+}
+
+void testDelete(void)
+{
+	coArena a = coNewArena(0);
+	co v;
+	CHECK(a != NULL);
+	CHECK(coArenaSize(a) == 0);
+	v = newArenaTree(a);
+	CHECK((v->flags & CO_ARENA) != 0);
+	CHECK(coArenaSize(a) > 0);
+	CHECK(isArenaTree(v));
+	coDelete(v);	// no effect for arena objects
+	coDelete((co)coVectorGet(v, 0));
+	coDelete((co)coVectorGet(v, 104));
+	CHECK(isArenaTree(v));	// still valid after coDelete()
+	coDeleteArena(a);	// releases v
+}
+
+void testMixed(void)
+{
+	coArena a = coNewArena(256);	// small chunks: many chunks and separate large blocks
+	co heap = coNewVector(CO_FREE_VALS);
+	co v = newArenaTree(a);
+	co clone;
+	co big;
+	char *s1, *s2;
+
+	// heap vector with arena elements: coDelete() of the heap vector keeps the arena elements
+	coVectorAdd(heap, coNewStr(CO_STRDUP, "heap"));
+	coVectorAdd(heap, v);
+	coVectorAdd(heap, coVectorGet(v, 0));
+	CHECK(isArenaTree(coVectorGet(heap, 1)));
+
+	// clone of an arena tree is a heap tree without CO_ARENA
+	clone = coClone(v);
+	CHECK(clone != NULL && (clone->flags & CO_ARENA) == 0);
+	CHECK(isArenaTree(clone));
+
+	// block larger than the chunk size
+	big = coNewMemWithArena(a, CO_STRDUP, json, strlen(json) + 1);
+	CHECK(big != NULL && coMemSize(big) == (long)strlen(json) + 1);
+	CHECK(strcmp((const char *)coMemGet(big), json) == 0);
+
+	coDelete(heap);
+	CHECK(isArenaTree(v));
+
+	// same result for heap and arena JSON parser
+	v = coReadJSONByStringWithArena(json, a);
+	heap = coReadJSONByString(json);
+	s1 = coWriteJSONToString(v, 1, 1);
+	s2 = coWriteJSONToString(heap, 1, 1);
+	CHECK(s1 != NULL && s2 != NULL && strcmp(s1, s2) == 0);
+	free(s1);
+	free(s2);
+	coDelete(heap);
+
+	coDeleteArena(a);	// releases v and big
+	CHECK(isArenaTree(clone));	// clone does not refer to arena memory
+	coDelete(clone);
+}
+
+int main(int argc, char **argv)
+{
+	int repeat = 1;
+	int i;
+	if ( argc == 3 && strcmp(argv[1], "-r") == 0 )
+		repeat = atoi(argv[2]);
+	for( i = 0; i < repeat; i++ )
+	{
+		testDelete();
+		testMixed();
+	}
+	coDeleteArena(NULL);	// allowed, no effect
+	if ( error_cnt == 0 )
+		printf("arena_test ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -0,0 +1,305 @@
+/*
+
+	bin_test
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	round trip test for the binary co format (coWriteBinary()):
+	the tree is written into a temporary file and read back with
+	coReadBinaryByFP() (buffered and, if enabled, gzip compressed),
+	coReadBinaryByFPWithArena() and coReadBinaryByMem().
+	Tables are compared column by column (tables are not supported inside an arena).
+	The trees contain large strings in front of vectors and memory images,
+	so that the element count is read when only a part of the input
+	is inside the window of the reader.
+
+	bin_test
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+/* string with len chars */
+co newLongStr(size_t len)
+{
+	char *s = (char *)malloc(len + 1);
+	co o;
+	if ( s == NULL )
+		return NULL;
+	memset(s, 'x', len);
+	s[len] = '\0';
+	o = coNewStr(CO_STRDUP, s);
+	free(s);
+	return o;
+}
+
+/* memory image with cnt blocks of 3 bytes */
+co newMemImage(long cnt)
+{
+	co o = coNewMemImage();
+	unsigned char data[3];
+	long i;
+	for( i = 0; i < cnt; i++ )
+	{
+		data[0] = (unsigned char)i;
+		data[1] = (unsigned char)(i >> 8);
+		data[2] = (unsigned char)(i >> 16);
+		if ( coMemImageAdd(o, (uint64_t)i * 16, data, 3) == 0 )
+			return coDelete(o), NULL;
+	}
+	return o;
+}
+
+/* vector with cnt numbers */
+co newVector(long cnt)
+{
+	co o = coNewVector(CO_FREE_VALS);
+	long i;
+	for( i = 0; i < cnt; i++ )
+		coVectorAdd(o, coNewDbl(i));
+	return o;
+}
+
+/*
+  write o into a temporary file and compare the result of all binary readers,
+  is_arena: 0 if the arena reader must fail
+*/
+void testRoundTripArena(cco o, int is_arena, int line)
+{
+	FILE *fp;
+	co r;
+	coArena a;
+	char *mem;
+	size_t len;
+	int is_gz;
+
+	for( is_gz = 0; is_gz < 2; is_gz++ )
+	{
+#ifndef CO_USE_ZLIB
+		if ( is_gz )
+			break;
+#endif
+		fp = tmpfile();
+		CHECK(fp != NULL);
+		if ( fp == NULL )
+			return;
+#ifdef CO_USE_ZLIB
+		if ( is_gz )
+			CHECK(coWriteBinaryGz(o, fp, 1));
+		else
+#endif
+			CHECK(coWriteBinary(o, fp));
+
+		rewind(fp);
+		r = coReadBinaryByFP(fp);
+		if ( isEqual(o, r) == 0 )
+			printf("line %d: coReadBinaryByFP failed (gzip=%d)\n", line, is_gz), error_cnt++;
+		coDelete(r);
+
+		// the zlib state is only released at the end of the gzip stream, so the expected error is only checked for plain files
+		if ( is_arena || is_gz == 0 )
+		{
+			rewind(fp);
+			a = coNewArena(0);
+			r = coReadBinaryByFPWithArena(fp, a);
+			if ( is_arena ? isEqual(o, r) == 0 : r != NULL )
+				printf("line %d: coReadBinaryByFPWithArena failed (gzip=%d)\n", line, is_gz), error_cnt++;
+			coDeleteArena(a);
+		}
+		fclose(fp);
+	}
+
+	mem = coWriteBinaryToMem(o, &len);
+	CHECK(mem != NULL);
+	r = coReadBinaryByMem(mem, len);
+	if ( isEqual(o, r) == 0 )
+		printf("line %d: coReadBinaryByMem failed\n", line), error_cnt++;
+	coDelete(r);
+	free(mem);
+}
+
+void testRoundTrip(cco o, int line)
+{
+	testRoundTripArena(o, 1, line);
+}
+
+void testLargePrefix(void)
+{
+	co o;
+
+	/* memory image with 100 blocks after a string, which fills the window */
+	o = coNewVector(CO_FREE_VALS);
+	coVectorAdd(o, newLongStr(32700));
+	coVectorAdd(o, newMemImage(100));
+	testRoundTrip(o, __LINE__);
+	coDelete(o);
+
+	/* same for a vector */
+	o = coNewVector(CO_FREE_VALS);
+	coVectorAdd(o, newLongStr(32700));
+	coVectorAdd(o, newVector(100));
+	testRoundTrip(o, __LINE__);
+	coDelete(o);
+
+	/* more blocks than bytes inside the window, the block list must grow */
+	o = coNewVector(CO_FREE_VALS);
+	coVectorAdd(o, newMemImage(50000));
+	coVectorAdd(o, newVector(50000));
+	testRoundTrip(o, __LINE__);
+	coDelete(o);
+}
+
+co newTable(void)
+{
+	static const char *dbl_list[] = { "1.5", "", "-0", "1e300", "x" };	// "" and "x" are NaN
+	static const char *auto_list[] = { "1", "2", "3.5", "", "abc" };
+	char buf[32];
+	co o = coNewTable();
+	long i;
+	coTableAddCol(o, "int", CO_COL_INT);
+	coTableAddCol(o, "dbl", CO_COL_DBL);
+	coTableAddCol(o, "str", CO_COL_STR);
+	coTableAddCol(o, "auto", CO_COL_AUTO);
+	for( i = 0; i < 1000; i++ )
+	{
+		sprintf(buf, "%ld", i % 2 ? -i*1000003 : i*1000003);
+		coTableAddField(o, 0, buf, strlen(buf));
+		coTableAddField(o, 1, dbl_list[i % 5], strlen(dbl_list[i % 5]));
+		sprintf(buf, "s%ld", i);
+		coTableAddField(o, 2, i % 7 ? buf : "", i % 7 ? strlen(buf) : 0);
+		coTableAddField(o, 3, auto_list[i % 5], strlen(auto_list[i % 5]));
+	}
+	return o;
+}
+
+void testTable(void)
+{
+	co o = newTable();
+	co v = coNewVector(CO_FREE_VALS);
+
+	/* the auto column is not resolved: it is written as strings */
+	CHECK(coTableColType(o, 3) == CO_COL_AUTO);
+	coVectorAdd(v, coNewStr(CO_STRDUP, "table"));
+	coVectorAdd(v, o);
+	testRoundTripArena(v, 0, __LINE__);
+	coTableFinish(o);
+	CHECK(coTableColType(o, 3) == CO_COL_STR);
+	testRoundTripArena(v, 0, __LINE__);
+	coDelete(v);
+
+	/* empty table and table without rows */
+	o = coNewTable();
+	testRoundTripArena(o, 0, __LINE__);
+	coTableAddCol(o, "x", CO_COL_DBL);
+	testRoundTripArena(o, 0, __LINE__);
+	coDelete(o);
+}
+
+/* corrupt block count: the reader must fail without allocating the count */
+void testIllegalCount(void)
+{
+	co o = newMemImage(2);
+	char *mem;
+	size_t len;
+	CHECK(o != NULL);
+	mem = coWriteBinaryToMem(o, &len);
+	coDelete(o);
+	CHECK(mem != NULL && len > 5);
+	CHECK((unsigned char)mem[5] == 2);	// magic (4 bytes), tag, count
+	mem[5] = 0x7f;	// claims 127 blocks
+	o = coReadBinaryByMem(mem, len);
+	CHECK(o == NULL);
+	free(mem);
+}
+
+/* blocks must be sorted and must not overlap or touch (adjacent blocks are merged by coMemImageAdd()) */
+void testUnsortedBlocks(void)
+{
+	co o = newMemImage(2);		// blocks 0..2 and 16..18
+	co r;
+	coArena a;
+	char *mem;
+	size_t len;
+	int i, is_arena;
+	int address_list[] = { 0, 1, 2, 3, 4, 16 };
+	int is_ok_list[] = { 0, 0, 0, 0, 1, 1 };
+
+	mem = coWriteBinaryToMem(o, &len);
+	coDelete(o);
+	CHECK(mem != NULL && len == 16);
+	CHECK(mem != NULL && mem[6] == 0 && mem[7] == 3 && mem[11] == 16);	// magic (4 bytes), tag, count, address, len, 3 bytes, address, len
+	if ( mem == NULL || len != 16 )
+		return;
+	for( i = 0; i < (int)(sizeof(address_list)/sizeof(*address_list)); i++ )
+	{
+		mem[11] = (char)address_list[i];
+		for( is_arena = 0; is_arena < 2; is_arena++ )
+		{
+			a = is_arena ? coNewArena(0) : NULL;
+			r = is_arena ? coReadBinaryByMemWithArena(mem, len, a) : coReadBinaryByMem(mem, len);
+			if ( (r != NULL) != is_ok_list[i] )
+				printf("second block at %d (arena=%d): reader %s\n", address_list[i], is_arena, r == NULL ? "failed" : "accepted illegal block"), error_cnt++;
+			if ( r != NULL )
+				CHECK(coMemImageSize(r) == 2 && coMemImageGetBlock(r, 1)->address == (uint64_t)address_list[i]);
+			if ( is_arena )
+				coDeleteArena(a);
+			else
+				coDelete(r);
+		}
+	}
+	free(mem);
+}
+
+/* len can be NULL, strings with '\0' keep their length with and without arena */
+void testStr(void)
+{
+	co o = coNewStr(CO_STRDUP, "a_cd");
+	co r;
+	coArena a;
+	char *mem, *p;
+	size_t len;
+	mem = coWriteBinaryToMem(o, &len);
+	p = coWriteBinaryToMem(o, NULL);
+	CHECK(mem != NULL && p != NULL && memcmp(mem, p, len) == 0);
+	free(p);
+	coDelete(o);
+
+	p = memchr(mem, '_', len);
+	CHECK(p != NULL);
+	if ( p == NULL )
+	{
+		free(mem);
+		return;
+	}
+	*p = '\0';		// "a\0cd"
+	r = coReadBinaryByMem(mem, len);
+	CHECK(r != NULL && coIsStr(r) && coSize(r) == 4 && memcmp(coStrGet(r), "a\0cd", 5) == 0);
+	coDelete(r);
+	a = coNewArena(0);
+	r = coReadBinaryByMemWithArena(mem, len, a);
+	CHECK(r != NULL && coIsStr(r) && coSize(r) == 4 && memcmp(coStrGet(r), "a\0cd", 5) == 0);
+	coDeleteArena(a);
+	free(mem);
+}
+
+int main(void)
+{
+	testLargePrefix();
+	testIllegalCount();
+	testStr();
+	testUnsortedBlocks();
+	testTable();
+	if ( error_cnt == 0 )
+		printf("bin_test ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}
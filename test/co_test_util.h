@@ -0,0 +1,145 @@
+/*
+
+	co_test_util.h
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	helper for the test programs, include this file once (after co.h):
+	  CHECK(cond)	print the line and increment error_cnt if cond is 0
+	  getEpochMilliseconds()
+	  isEqual(a, b)	deep compare of two co objects
+
+*/
+
+#ifndef CO_TEST_UTIL_INCLUDE
+#define CO_TEST_UTIL_INCLUDE
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include "co.h"
+
+static int error_cnt = 0;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static inline void check(int cond, const char *s, int line)
+{
+	if ( cond == 0 )
+	{
+		printf("line %d: '%s' failed\n", line, s);
+		error_cnt++;
+	}
+}
+
+static inline uint64_t getEpochMilliseconds(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
+}
+
+/* return 1 if both tables are identical, NaN values are equal */
+static inline int isEqualTable(cco a, cco b)
+{
+	long col, row, cnt;
+	const char *x, *y;
+	if ( coTableColCnt(a) != coTableColCnt(b) || coTableSize(a) != coTableSize(b) )
+		return 0;
+	cnt = coTableSize(a);
+	for( col = 0; col < coTableColCnt(a); col++ )
+	{
+		if ( strcmp(coTableColName(a, col), coTableColName(b, col)) != 0 || coTableColType(a, col) != coTableColType(b, col) )
+			return 0;
+		if ( coTableColType(a, col) == CO_COL_INT )
+		{
+			if ( cnt > 0 && memcmp(coTableGetInt(a, col), coTableGetInt(b, col), cnt*sizeof(int64_t)) != 0 )
+				return 0;
+		}
+		else if ( coTableColType(a, col) == CO_COL_DBL )
+		{
+			if ( cnt > 0 && memcmp(coTableGetDbl(a, col), coTableGetDbl(b, col), cnt*sizeof(double)) != 0 )
+				return 0;
+		}
+		else if ( coTableColType(a, col) == CO_COL_STR )
+		{
+			for( row = 0; row < cnt; row++ )
+			{
+				x = coTableGetStr(a, col, row);
+				y = coTableGetStr(b, col, row);
+				if ( x == NULL || y == NULL || strcmp(x, y) != 0 )
+					return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/* return 1 if both objects are identical, strings are compared with coSize() chars (may include '\0') */
+static inline int isEqual(cco a, cco b)
+{
+	long i, cnt;
+	const struct co_mem_block_struct *x, *y;
+	if ( a == NULL || b == NULL )
+		return a == b;
+	if ( coGetType(a) != coGetType(b) )
+		return 0;
+	if ( coIsStr(a) )
+		return coSize(a) == coSize(b) && memcmp(coStrGet(a), coStrGet(b), coSize(a)) == 0;
+	if ( coIsMem(a) )
+		return coMemSize(a) == coMemSize(b) && memcmp(coMemGet(a), coMemGet(b), coMemSize(a)) == 0;
+	if ( coIsDbl(a) )
+		return coDblGet(a) == coDblGet(b);
+	if ( coIsBool(a) )
+		return coBoolGet(a) == coBoolGet(b);
+	if ( coIsVector(a) )
+	{
+		cnt = coVectorSize(a);
+		if ( cnt != coVectorSize(b) )
+			return 0;
+		for( i = 0; i < cnt; i++ )
+			if ( isEqual(coVectorGet(a, i), coVectorGet(b, i)) == 0 )
+				return 0;
+		return 1;
+	}
+	if ( coIsMap(a) )
+	{
+		coMapIterator iter;
+		if ( coMapSize(a) != coMapSize(b) )
+			return 0;
+		if ( coMapLoopFirst(&iter, a) )
+		{
+			do
+			{
+				if ( coMapExists(b, coMapLoopKey(&iter)) == 0 )
+					return 0;
+				if ( isEqual(coMapLoopValue(&iter), coMapGet(b, coMapLoopKey(&iter))) == 0 )
+					return 0;
+			} while( coMapLoopNext(&iter) );
+		}
+		return 1;
+	}
+	if ( coIsMemImage(a) )
+	{
+		cnt = coMemImageSize(a);
+		if ( cnt != coMemImageSize(b) )
+			return 0;
+		for( i = 0; i < cnt; i++ )
+		{
+			x = coMemImageGetBlock(a, i);
+			y = coMemImageGetBlock(b, i);
+			if ( x->address != y->address || x->len != y->len || memcmp(x->data, y->data, x->len) != 0 )
+				return 0;
+		}
+		return 1;
+	}
+	if ( coIsTable(a) )
+		return isEqualTable(a, b);
+	return 0;
+}
+
+#endif /* CO_TEST_UTIL_INCLUDE */
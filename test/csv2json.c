@@ -1,21 +1,43 @@
 
 
 #include "co.h"
+#include <string.h>
+#include <stdlib.h>
 
 int main(int argc, char **argv)
 {
     co csvco;
+    int thread_cnt = 1;
   
-    // any of the three following pool inits is possible
+    // any of the three following pool inits is possible, "-s" will use coNewStrPool()
     //co pool = coNewMap(CO_FREE_VALS | CO_STRDUP);
     co pool = coNewMap(CO_FREE_VALS);
     //co pool = NULL;
     FILE *csvfp;
     FILE *jsonfp;
     
+    for(;;)
+    {
+      if ( argc >= 3 && strcmp(argv[1], "-t") == 0 )
+      {
+              thread_cnt = atoi(argv[2]);
+              argv += 2;
+              argc -= 2;
+      }
+      else if ( argc >= 2 && strcmp(argv[1], "-s") == 0 )
+      {
+              coDelete(pool);
+              pool = coNewStrPool();
+              argv++;
+              argc--;
+      }
+      else
+        break;
+    }
     if ( argc != 3 )
     {
-            printf("%s in.csv out.json\n", argv[0]);
+            printf("%s [-t threads] [-s] in.csv out.json\n", argv[0]);
+            printf("  -s   use a string pool and print the pool statistics\n");
             return 1;
     }
     csvfp = fopen(argv[1], "rb");
@@ -32,7 +54,7 @@ int main(int argc, char **argv)
             return 3;
     }
     
-    csvco = coReadCSVByFPWithPool(csvfp, ',', pool);
+    csvco = coReadCSVByFPParallel(csvfp, ',', pool, thread_cnt);
     coWriteJSON(csvco, 0, 1, jsonfp);	
     coPrint(pool); puts("");
     
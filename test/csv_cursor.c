@@ -0,0 +1,244 @@
+/*
+
+	csv_cursor
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	test for the CSV cursor (coCSVCursorInit(), coCSVCursorNext()):
+	- quoted fields, escaped quotes, empty fields, LF and CRLF
+	- quoted fields with embedded newlines
+	- fields with '\0' (len is the byte length), also for coCSVCursorGetRow()
+	  without pool, with a string pool and with a map pool (read error)
+	- the row buffer and the field list are reused for all rows
+	- rows, which cross the window of the FP reader
+
+	csv_cursor
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+/* return 1 if field i of the current row is identical to s (with len bytes) */
+int isField(coCSVCursor c, long i, const char *s, size_t len)
+{
+	if ( i >= coCSVCursorCnt(c) )
+		return 0;
+	if ( coCSVCursorLen(c, i) != len )
+		return 0;
+	if ( coCSVCursorStr(c, i)[len] != '\0' )
+		return 0;
+	return memcmp(coCSVCursorStr(c, i), s, len) == 0;
+}
+
+#define IS_FIELD(c, i, s) isField((c), (i), (s), strlen(s))
+
+void testQuoted(void)
+{
+	const char *csv =
+		"a,\"b,c\",\"d \"\"q\"\" e\"\n"
+		"\"multi\nline\",,x\r\n"
+		"\"\",\"cr\r\nlf\",end";
+	struct co_reader_struct reader;
+	struct co_csv_cursor_struct c;
+
+	CHECK(coReaderInitByString(&reader, csv));
+	CHECK(coCSVCursorInit(&c, &reader, ','));
+
+	CHECK(coCSVCursorNext(&c) == 3);
+	CHECK(IS_FIELD(&c, 0, "a"));
+	CHECK(IS_FIELD(&c, 1, "b,c"));
+	CHECK(IS_FIELD(&c, 2, "d \"q\" e"));
+
+	CHECK(coCSVCursorNext(&c) == 3);
+	CHECK(IS_FIELD(&c, 0, "multi\nline"));
+	CHECK(IS_FIELD(&c, 1, ""));
+	CHECK(IS_FIELD(&c, 2, "x"));
+
+	CHECK(coCSVCursorNext(&c) == 3);
+	CHECK(IS_FIELD(&c, 0, ""));
+	CHECK(IS_FIELD(&c, 1, "cr\r\nlf"));
+	CHECK(IS_FIELD(&c, 2, "end"));
+
+	CHECK(coCSVCursorNext(&c) == 0);
+	CHECK(c.row_nr == 3);
+	coCSVCursorClose(&c);
+}
+
+void testZero(void)
+{
+	const char csv[] = "x\0y,z\n\"q\0\",w\n";
+	struct co_reader_struct reader;
+	struct co_csv_cursor_struct c;
+
+	CHECK(coReaderInitByMem(&reader, csv, sizeof(csv)-1));
+	CHECK(coCSVCursorInit(&c, &reader, ','));
+	CHECK(coCSVCursorNext(&c) == 2);
+	CHECK(isField(&c, 0, "x\0y", 3));
+	CHECK(strlen(coCSVCursorStr(&c, 0)) == 1);
+	CHECK(IS_FIELD(&c, 1, "z"));
+	CHECK(coCSVCursorNext(&c) == 2);
+	CHECK(isField(&c, 0, "q\0", 2));
+	CHECK(IS_FIELD(&c, 1, "w"));
+	CHECK(coCSVCursorNext(&c) == 0);
+	coCSVCursorClose(&c);
+}
+
+/* coCSVCursorGetRow() keeps the length of fields with '\0' */
+void testZeroRow(void)
+{
+	const char csv[] = "x\0y,z\n\"q\0\",w\n";
+	struct co_reader_struct reader;
+	struct co_csv_cursor_struct c;
+	co pool;
+	co row;
+	int pool_type;
+
+	for( pool_type = 0; pool_type < 3; pool_type++ )	// 0: no pool, 1: string pool, 2: map
+	{
+		pool = pool_type == 0 ? NULL : pool_type == 1 ? coNewStrPool() : coNewMap(CO_FREE_VALS);
+		CHECK(coReaderInitByMem(&reader, csv, sizeof(csv)-1));
+		CHECK(coCSVCursorInit(&c, &reader, ','));
+		CHECK(coCSVCursorNext(&c) == 2);
+		row = coCSVCursorGetRow(&c, pool);
+		if ( pool_type == 2 )
+		{
+			CHECK(row == NULL);	// a map key can't contain '\0'
+		}
+		else
+		{
+			CHECK(coVectorSize(row) == 2);
+			CHECK(coSize(coVectorGet(row, 0)) == 3 && memcmp(coStrGet(coVectorGet(row, 0)), "x\0y", 4) == 0);
+			CHECK(coSize(coVectorGet(row, 1)) == 1 && strcmp(coStrGet(coVectorGet(row, 1)), "z") == 0);
+		}
+		coDelete(row);
+		CHECK(coCSVCursorNext(&c) == 2);
+		row = coCSVCursorGetRow(&c, pool);
+		if ( pool_type != 2 )
+			CHECK(row != NULL && coSize(coVectorGet(row, 0)) == 2 && memcmp(coStrGet(coVectorGet(row, 0)), "q\0", 3) == 0);
+		coDelete(row);
+		coCSVCursorClose(&c);
+		coDelete(pool);
+	}
+}
+
+void testReuse(void)
+{
+	struct co_reader_struct reader;
+	struct co_csv_cursor_struct c;
+	char *csv;
+	char *p;
+	char *buf;
+	size_t buf_size, field_max;
+	long i;
+
+	/* short row, long row (100 fields with 40 chars), short row */
+	csv = (char *)malloc(8000);
+	CHECK(csv != NULL);
+	if ( csv == NULL )
+		return;
+	strcpy(csv, "a,b\n");
+	p = csv + strlen(csv);
+	for( i = 0; i < 100; i++ )
+	{
+		if ( i > 0 )
+			*p++ = ',';
+		memset(p, 'a' + i % 26, 40);
+		p += 40;
+	}
+	strcpy(p, "\nc,d\n");
+
+	CHECK(coReaderInitByString(&reader, csv));
+	CHECK(coCSVCursorInit(&c, &reader, ','));
+	CHECK(coCSVCursorNext(&c) == 2);
+	CHECK(coCSVCursorStr(&c, 0) == c.buf);	// fields are inside the row buffer
+
+	CHECK(coCSVCursorNext(&c) == 100);
+	CHECK(c.buf_size >= 100*41);
+	CHECK(c.field_max >= 100);
+	for( i = 0; i < 100; i++ )
+	{
+		CHECK(coCSVCursorLen(&c, i) == 40);
+		CHECK(coCSVCursorStr(&c, i)[0] == 'a' + i % 26);
+		CHECK(coCSVCursorStr(&c, i) >= c.buf && coCSVCursorStr(&c, i) + 40 < c.buf + c.buf_size);
+	}
+	buf = c.buf;
+	buf_size = c.buf_size;
+	field_max = c.field_max;
+
+	/* the buffer of the large row is reused, it doesn't shrink */
+	CHECK(coCSVCursorNext(&c) == 2);
+	CHECK(c.buf == buf);
+	CHECK(c.buf_size == buf_size);
+	CHECK(c.field_max == field_max);
+	CHECK(IS_FIELD(&c, 0, "c"));
+	CHECK(IS_FIELD(&c, 1, "d"));
+	CHECK(coCSVCursorStr(&c, 0) == buf);
+	CHECK(coCSVCursorNext(&c) == 0);
+	coCSVCursorClose(&c);
+	free(csv);
+}
+
+/* many rows with embedded newlines, which cross the window of the FP reader */
+void testFP(void)
+{
+	FILE *fp = tmpfile();
+	struct co_reader_struct reader;
+	struct co_csv_cursor_struct c;
+	char expected[64];
+	long i, cnt = 20000;
+	int is_ok = 1;
+
+	CHECK(fp != NULL);
+	if ( fp == NULL )
+		return;
+	for( i = 0; i < cnt; i++ )
+		fprintf(fp, "%ld,\"line\n%ld\",\"%s\"\n", i, i, i % 3 == 0 ? "" : "q\"\"q");
+	rewind(fp);
+
+	CHECK(coReaderInitByFP(&reader, fp));
+	CHECK(coCSVCursorInit(&c, &reader, ','));
+	for( i = 0; i < cnt && is_ok; i++ )
+	{
+		is_ok = 0;
+		if ( coCSVCursorNext(&c) != 3 )
+			break;
+		sprintf(expected, "%ld", i);
+		if ( IS_FIELD(&c, 0, expected) == 0 )
+			break;
+		sprintf(expected, "line\n%ld", i);
+		if ( IS_FIELD(&c, 1, expected) == 0 )
+			break;
+		if ( IS_FIELD(&c, 2, i % 3 == 0 ? "" : "q\"q") == 0 )
+			break;
+		is_ok = 1;
+	}
+	if ( is_ok == 0 )
+		printf("FP reader: wrong row %ld\n", i);
+	CHECK(is_ok);
+	CHECK(coCSVCursorNext(&c) == 0);
+	CHECK(c.row_nr == cnt);
+	coCSVCursorClose(&c);
+	fclose(fp);
+}
+
+int main(void)
+{
+	testQuoted();
+	testZero();
+	testZeroRow();
+	testReuse();
+	testFP();
+	if ( error_cnt == 0 )
+		printf("csv_cursor ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/*
+
+	csv_parallel
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	test for the parallel CSV reader (coReadCSVByFPParallelWithInfo()):
+	a generated CSV file with quoted LF, CR and separators, "\n\r", "\r\n",
+	"\r" and "\n" line ends and leading blanks is split into small chunks, so
+	that chunks start inside a quoted field and must be parsed again (fix-up).
+	The result is compared with the serial reader (coReadCSVByFPWithPool())
+	without pool, with a map as pool and with a string pool.
+
+	csv_parallel
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define ROW_CNT 4000
+
+uint64_t rnd_state = 88172645463325252ULL;
+
+uint64_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 7;
+	rnd_state ^= rnd_state << 17;
+	return rnd_state;
+}
+
+/* quoted field content, which requires the fix-up if a chunk starts after one of the line feeds */
+const char *quoted_list[] = {
+	"\"multi\nline\"",
+	"\"lf\n\nlf\"",
+	"\"cr\rlf\n\"",
+	"\"crlf\r\nx\"",
+	"\"lfcr\n\ry\"",
+	"\"sep,\n\"\"q\"\"\n\"",
+	"\"\n\"",
+};
+
+const char *eol_list[] = { "\n", "\r\n", "\n\r", "\r" };
+
+/* temporary file with ROW_CNT rows, the rows have a different number of fields */
+FILE *createCSV(void)
+{
+	FILE *fp = tmpfile();
+	long i;
+	int j, cnt;
+	if ( fp == NULL )
+		return NULL;
+	fputs("  ", fp);		// leading blanks of the first row are skipped
+	for( i = 0; i < ROW_CNT; i++ )
+	{
+		cnt = 1 + (int)(rnd() % 5);
+		for( j = 0; j < cnt; j++ )
+		{
+			if ( j > 0 )
+				fputc(',', fp);
+			switch( j == 0 ? rnd() % 2 : rnd() % 5 )	// the first field is not empty, so each row has exactly one line end
+			{
+				case 0:
+					fputs(quoted_list[rnd() % (sizeof(quoted_list)/sizeof(*quoted_list))], fp);
+					break;
+				case 1:
+					fprintf(fp, " blank%ld", (long)(rnd() % 50));	// leading blanks are part of the field
+					break;
+				case 2:
+					break;		// empty field
+				default:
+					fprintf(fp, "%ld", (long)(rnd() % 200));
+					break;
+			}
+		}
+		fputs(eol_list[rnd() % (sizeof(eol_list)/sizeof(*eol_list))], fp);
+	}
+	fputs("last,\"row\nwithout\",eol", fp);
+	return fp;
+}
+
+/* return 1 if all strings of the csv vector are stored inside the pool */
+int isPooled(cco csv, co pool)
+{
+	long i, j;
+	cco row, field;
+	for( i = 0; i < coVectorSize(csv); i++ )
+	{
+		row = coVectorGet(csv, i);
+		for( j = 0; j < coVectorSize(row); j++ )
+		{
+			field = coVectorGet(row, j);
+			if ( coIsStrPool(pool) )
+			{
+				if ( coStrPoolAdd(pool, coStrGet(field), coSize(field)) != field )
+					return 0;
+			}
+			else if ( coMapGet(pool, coStrGet(field)) != field )
+				return 0;
+		}
+	}
+	return 1;
+}
+
+/* pool_type: 0: no pool, 1: map, 2: string pool */
+co newPool(int pool_type)
+{
+	if ( pool_type == 1 )
+		return coNewMap(CO_FREE_VALS);
+	if ( pool_type == 2 )
+		return coNewStrPool();
+	return NULL;
+}
+
+/* returns the number of chunks, which were parsed again */
+long compareCSV(FILE *fp, int pool_type, int thread_cnt, size_t chunk_size)
+{
+	co ref_pool = newPool(pool_type);
+	co pool = newPool(pool_type);
+	co ref, o;
+	coParallelInfo info;
+
+	fseek(fp, 0, SEEK_SET);
+	ref = coReadCSVByFPWithPool(fp, ',', ref_pool);
+	fseek(fp, 0, SEEK_SET);
+	info.chunk_size = chunk_size;
+	o = coReadCSVByFPParallelWithInfo(fp, ',', pool, thread_cnt, &info);
+
+	CHECK(coVectorSize(ref) == ROW_CNT+1);
+	if ( isEqual(ref, o) == 0 )
+		printf("pool=%d threads=%d chunk_size=%lu: different result\n", pool_type, thread_cnt, (unsigned long)chunk_size), error_cnt++;
+	CHECK(info.thread_cnt > 1 && info.thread_cnt <= thread_cnt);
+	CHECK(info.chunk_cnt > 1);
+	if ( pool != NULL )
+		CHECK(isPooled(o, pool));
+	if ( pool_type == 1 )
+		CHECK(coMapSize(pool) == coMapSize(ref_pool));
+
+	coDelete(o);
+	coDelete(ref);
+	coDelete(pool);
+	coDelete(ref_pool);
+	return info.reparse_cnt;
+}
+
+/* thread_cnt 1 uses the serial reader */
+void testSerial(FILE *fp)
+{
+	co ref, o;
+	coParallelInfo info;
+	fseek(fp, 0, SEEK_SET);
+	ref = coReadCSVByFP(fp, ',');
+	fseek(fp, 0, SEEK_SET);
+	info.chunk_size = 64;
+	o = coReadCSVByFPParallelWithInfo(fp, ',', NULL, 1, &info);
+	CHECK(isEqual(ref, o));
+	CHECK(info.thread_cnt == 0);
+	CHECK(info.chunk_cnt == 0);
+	coDelete(o);
+	coDelete(ref);
+}
+
+int main(void)
+{
+	FILE *fp = createCSV();
+	size_t chunk_size_list[] = { 1, 64, 300, 4096 };
+	int thread_list[] = { 2, 3, 8 };
+	int pool_type, t, c;
+	long reparse_cnt = 0;
+
+	if ( fp == NULL )
+		return perror("tmpfile"), 1;
+	for( pool_type = 0; pool_type < 3; pool_type++ )
+		for( t = 0; t < (int)(sizeof(thread_list)/sizeof(*thread_list)); t++ )
+			for( c = 0; c < (int)(sizeof(chunk_size_list)/sizeof(*chunk_size_list)); c++ )
+				reparse_cnt += compareCSV(fp, pool_type, thread_list[t], chunk_size_list[c]);
+	printf("chunks parsed again: %ld\n", reparse_cnt);
+	CHECK(reparse_cnt > 0);		// the fix-up must have been executed
+	testSerial(fp);
+	fclose(fp);
+	if ( error_cnt == 0 )
+		printf("csv_parallel ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -0,0 +1,370 @@
+/*
+
+	csv_table
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	regression test for the CSV table reader: the table from
+	coReadCSVTableByFP() is compared with the vector of vectors from
+	coReadCSVByFP() for the same file:
+	- int, dbl and str columns: each value is converted from the string of
+	  the vector reader
+	- auto columns: the final type is int, dbl or str, depending on all
+	  values of the column
+	- schema: column names and numbers, order, unknown columns
+	A generated file is always tested, additional files are read with
+	all columns (with and without header line).
+
+	csv_table [file.csv ...]
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+		2		some error has happend (read error)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define ROW_CNT 3000
+
+/* copy s without leading and trailing blanks and tabs into buf */
+const char *trim(const char *s, char *buf, size_t size)
+{
+	size_t len;
+	while( *s == ' ' || *s == '\t' )
+		s++;
+	len = strlen(s);
+	while( len > 0 && (s[len-1] == ' ' || s[len-1] == '\t') )
+		len--;
+	if ( len >= size )
+		len = size-1;
+	memcpy(buf, s, len);
+	buf[len] = '\0';
+	return buf;
+}
+
+/* returns 1 if s is an integer, which fits into int64_t */
+int getInt(const char *s, int64_t *n)
+{
+	char buf[1024];
+	char *end;
+	const char *p;
+	s = trim(s, buf, sizeof(buf));
+	p = s;
+	if ( *p == '-' || *p == '+' )
+		p++;
+	if ( *p < '0' || *p > '9' )
+		return 0;
+	for( ; *p != '\0'; p++ )
+		if ( *p < '0' || *p > '9' )
+			return 0;
+	errno = 0;
+	*n = (int64_t)strtoll(s, &end, 10);
+	return errno == 0 && *end == '\0';
+}
+
+/* returns 1 if s is a decimal number or empty (NaN) */
+int getDbl(const char *s, double *d)
+{
+	char buf[1024];
+	const char *p;
+	int digits = 0;
+	s = trim(s, buf, sizeof(buf));
+	if ( *s == '\0' )
+		return *d = NAN, 1;
+	p = s;
+	if ( *p == '-' || *p == '+' )
+		p++;
+	for( ; *p >= '0' && *p <= '9'; p++ )
+		digits++;
+	if ( *p == '.' )
+		for( p++; *p >= '0' && *p <= '9'; p++ )
+			digits++;
+	if ( digits == 0 )
+		return 0;
+	if ( *p == 'e' || *p == 'E' )
+	{
+		p++;
+		if ( *p == '-' || *p == '+' )
+			p++;
+		if ( *p < '0' || *p > '9' )
+			return 0;
+		while( *p >= '0' && *p <= '9' )
+			p++;
+	}
+	if ( *p != '\0' )
+		return 0;
+	*d = strtod(s, NULL);
+	return 1;
+}
+
+/* field f of row r of the vector reader, "" for missing fields */
+const char *getField(cco vec, long r, long f)
+{
+	cco row = coVectorGet(vec, r);
+	if ( f < 0 || f >= coVectorSize(row) )
+		return "";
+	return coStrGet(coVectorGet(row, f));
+}
+
+/* final type of an auto column */
+int getAutoType(cco vec, long first, long f)
+{
+	int64_t n;
+	double d;
+	int type = CO_COL_INT;
+	long r;
+	for( r = first; r < coVectorSize(vec); r++ )
+	{
+		if ( type == CO_COL_INT && getInt(getField(vec, r, f), &n) == 0 )
+			type = CO_COL_DBL;
+		if ( type == CO_COL_DBL && getDbl(getField(vec, r, f), &d) == 0 )
+			return CO_COL_STR;
+	}
+	return type;
+}
+
+/*
+  compare column col of table t with field f of the vector reader, first is
+  the first data row (1 with header line), type is the type from the schema
+*/
+int compareCol(cco t, long col, cco vec, long first, long f, int type, const char *name)
+{
+	long r, cnt = coVectorSize(vec) - first;
+	const char *s;
+	int64_t n;
+	double d;
+	if ( cnt < 0 )
+		cnt = 0;
+	if ( type == CO_COL_AUTO )
+		type = getAutoType(vec, first, f);
+	if ( coTableColType(t, col) != type )
+		return printf("%s: column %ld, type %d expected, table type %d\n", name, col, type, coTableColType(t, col)), 0;
+	if ( coTableSize(t) != cnt )
+		return printf("%s: %ld rows expected, table has %ld rows\n", name, cnt, coTableSize(t)), 0;
+	for( r = 0; r < cnt; r++ )
+	{
+		s = getField(vec, r + first, f);
+		if ( type == CO_COL_INT )
+		{
+			if ( getInt(s, &n) == 0 )
+				n = 0;
+			if ( coTableGetInt(t, col)[r] != n )
+				return printf("%s: column %ld, row %ld: int value '%s' differs\n", name, col, r, s), 0;
+		}
+		else if ( type == CO_COL_DBL )
+		{
+			if ( getDbl(s, &d) == 0 )
+				d = NAN;
+			if ( memcmp(&d, coTableGetDbl(t, col) + r, sizeof(double)) != 0 && !(isnan(d) && isnan(coTableGetDbl(t, col)[r])) )
+				return printf("%s: column %ld, row %ld: dbl value '%s' differs\n", name, col, r, s), 0;
+		}
+		else
+		{
+			if ( strcmp(coTableGetStr(t, col, r), s) != 0 )
+				return printf("%s: column %ld, row %ld: str value '%s' differs\n", name, col, r, s), 0;
+		}
+	}
+	return 1;
+}
+
+co readTable(FILE *fp, const char *schema, unsigned flags)
+{
+	rewind(fp);
+	return coReadCSVTableByFP(fp, ',', schema, flags);
+}
+
+/* read the table with all columns and compare it with the vector reader */
+void compareAll(FILE *fp, cco vec, unsigned flags, const char *name)
+{
+	co t = readTable(fp, NULL, flags);
+	long col;
+	long first = (flags & CO_CSV_HEADER) ? 1 : 0;
+	char col_name[32];
+
+	if ( t == NULL )
+	{
+		printf("%s: table read error\n", name);
+		error_cnt++;
+		return;
+	}
+	if ( coVectorSize(vec) > 0 && coTableColCnt(t) != coVectorSize(coVectorGet(vec, 0)) )
+	{
+		printf("%s: %ld columns expected, table has %ld columns\n", name, coVectorSize(coVectorGet(vec, 0)), coTableColCnt(t));
+		error_cnt++;
+	}
+	for( col = 0; col < coTableColCnt(t); col++ )
+	{
+		if ( first )
+			CHECK(strcmp(coTableColName(t, col), getField(vec, 0, col)) == 0);
+		else
+		{
+			sprintf(col_name, "%ld", col);
+			CHECK(strcmp(coTableColName(t, col), col_name) == 0);
+		}
+		if ( compareCol(t, col, vec, first, col, CO_COL_AUTO, name) == 0 )
+			error_cnt++;
+	}
+	coDelete(t);
+}
+
+co readVector(FILE *fp)
+{
+	rewind(fp);
+	return coReadCSVByFP(fp, ',');
+}
+
+/*===================================================================*/
+
+const char *header = "name,id,price,int_dbl,dbl_str,empty_int,quoted,big";
+
+FILE *generateCSV(void)
+{
+	FILE *fp = tmpfile();
+	long i;
+	if ( fp == NULL )
+		return NULL;
+	fprintf(fp, "%s\n", header);
+	for( i = 0; i < ROW_CNT; i++ )
+	{
+		fprintf(fp, "%sname %ld", i % 3 ? "" : " ", i);	// name: str, blank at the beginning of the row
+		fprintf(fp, ",%ld", i);	// id: int
+		fprintf(fp, ",%s%ld.%02ld", i % 2 ? "-" : "", i, i % 100);	// price: dbl
+		if ( i == ROW_CNT/2 )
+			fprintf(fp, ",1.5e3");	// int_dbl: int, one dbl value
+		else
+			fprintf(fp, ", %ld ", i*7);
+		if ( i == ROW_CNT-1 )
+			fprintf(fp, ",x");	// dbl_str: dbl, the last value is a string
+		else
+			fprintf(fp, ",%ld.25", i);
+		fprintf(fp, ",%s", i % 10 == 5 ? "" : "42");	// empty_int: int and empty -> dbl
+		fprintf(fp, ",\"q,\"\"%ld\"\"\n\"", i);	// quoted: str with separator, quote and newline
+		if ( i % 100 == 99 )
+		{
+			fprintf(fp, "\r\n");	// short row (big is missing), CRLF
+			continue;
+		}
+
+		fprintf(fp, ",%s\n", i % 2 ? "9223372036854775807" : "-9223372036854775808");	// big: int64 limits
+	}
+	fflush(fp);
+	return fp;
+}
+
+void testGenerated(void)
+{
+	static const char *type_list[] = { "auto", "int", "dbl", "str" };
+	static const int auto_type[] = { CO_COL_STR, CO_COL_INT, CO_COL_DBL, CO_COL_DBL, CO_COL_STR, CO_COL_DBL, CO_COL_STR, CO_COL_DBL };	// big: missing fields are empty -> dbl
+	FILE *fp = generateCSV();
+	co vec;
+	co t;
+	char schema[64];
+	long col, type;
+
+	if ( fp == NULL )
+	{
+		printf("tmpfile error\n");
+		exit(2);
+	}
+	vec = readVector(fp);
+	if ( vec == NULL )
+	{
+		printf("generated: vector read error\n");
+		exit(2);
+	}
+	CHECK(coVectorSize(vec) == ROW_CNT+1);
+
+	/* all columns as auto, with and without header */
+	compareAll(fp, vec, CO_CSV_HEADER, "generated");
+	compareAll(fp, vec, 0, "generated without header");
+	t = readTable(fp, NULL, CO_CSV_HEADER);
+	CHECK(t != NULL);
+	for( col = 0; t != NULL && col < 8; col++ )
+		CHECK(coTableColType(t, col) == auto_type[col]);
+	coDelete(t);
+
+	/* each column with each type, by name and by number */
+	for( col = 0; col < 8; col++ )
+	{
+		for( type = 0; type < 4; type++ )
+		{
+			sprintf(schema, "%s:%s", getField(vec, 0, col), type_list[type]);
+			t = readTable(fp, schema, CO_CSV_HEADER);
+			if ( t == NULL || coTableColCnt(t) != 1 || compareCol(t, 0, vec, 1, col, type, schema) == 0 )
+			{
+				printf("generated: schema '%s' failed\n", schema);
+				error_cnt++;
+			}
+			coDelete(t);
+			sprintf(schema, "%ld:%s", col, type_list[type]);
+			t = readTable(fp, schema, 0);
+			if ( t == NULL || coTableColCnt(t) != 1 || compareCol(t, 0, vec, 0, col, type, schema) == 0 )
+			{
+				printf("generated: schema '%s' without header failed\n", schema);
+				error_cnt++;
+			}
+			coDelete(t);
+		}
+	}
+
+	/* order of the schema, empty entries, column number with header */
+	t = readTable(fp, "price,,id:int,0:str,", CO_CSV_HEADER);
+	CHECK(t != NULL);
+	if ( t != NULL )
+	{
+		CHECK(coTableColCnt(t) == 3);
+		CHECK(strcmp(coTableColName(t, 0), "price") == 0);
+		CHECK(strcmp(coTableColName(t, 1), "id") == 0);
+		CHECK(strcmp(coTableColName(t, 2), "0") == 0);
+		CHECK(compareCol(t, 0, vec, 1, 2, CO_COL_AUTO, "order"));
+		CHECK(compareCol(t, 1, vec, 1, 1, CO_COL_INT, "order"));
+		CHECK(compareCol(t, 2, vec, 1, 0, CO_COL_STR, "order"));
+	}
+	coDelete(t);
+
+	/* schema errors: unknown name, names without header, illegal number */
+	printf("expected errors:\n");
+	CHECK(readTable(fp, "id,unknown", CO_CSV_HEADER) == NULL);
+	CHECK(readTable(fp, "id", 0) == NULL);
+	CHECK(readTable(fp, "-1:int", 0) == NULL);
+	CHECK(readTable(fp, "id:xyz", CO_CSV_HEADER) == NULL);	// "id:xyz" is not a column name
+
+	coDelete(vec);
+	fclose(fp);
+}
+
+int main(int argc, char **argv)
+{
+	FILE *fp;
+	co vec;
+
+	testGenerated();
+	argv++;
+	while( *argv != NULL )
+	{
+		fp = fopen(*argv, "rb");
+		vec = fp == NULL ? NULL : readVector(fp);
+		if ( vec == NULL )
+		{
+			printf("read error: '%s'\n", *argv);
+			return 2;
+		}
+		compareAll(fp, vec, CO_CSV_HEADER, *argv);
+		compareAll(fp, vec, 0, *argv);
+		coDelete(vec);
+		fclose(fp);
+		argv++;
+	}
+	printf("csv_table: errors=%d\n", error_cnt);
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -1,12 +1,12 @@
 
-
 #include "co.h"
 
 int main(int argc, char **argv)
 {
-    co rowVector;
     FILE *csvfp;
     struct co_reader_struct reader;
+    struct co_csv_cursor_struct cursor;
+    long i, cnt;
     
     if ( argc != 2 )
     {
@@ -22,16 +22,23 @@ int main(int argc, char **argv)
     
     if ( coReaderInitByFP(&reader, csvfp) == 0 )
       return fclose(csvfp), 3;
+    if ( coCSVCursorInit(&cursor, &reader, ',') == 0 )
+      return fclose(csvfp), 4;
+    // same output as coPrint() for the row vector, but without any allocation per row
     for (;;) {
-      rowVector = coGetCSVRow(&reader, ',');
-      if ( rowVector == NULL )
+      cnt = coCSVCursorNext(&cursor);
+      if ( cnt <= 0 )
         break;
-      coPrint(rowVector); puts("");
-      coDelete(rowVector);
+      printf("[");
+      for( i = 0; i < cnt; i++ ) {
+        if ( i > 0 )
+          printf(", ");
+        fwrite(coCSVCursorStr(&cursor, i), 1, coCSVCursorLen(&cursor, i), stdout);
+      }
+      printf("]\n");
     } 
 
-    
+    coCSVCursorClose(&cursor);
     fclose(csvfp);
-    return 0;
+    return cnt < 0 ? 5 : 0;
 }
-
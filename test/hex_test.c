@@ -0,0 +1,142 @@
+/*
+
+	hex_test
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	test for coHexToMem(): the scalar, SSE2 and AVX2 implementation
+	(selected by coSetSIMD()) are compared with a reference implementation.
+	Random hex strings with mixed case, all lengths up to 300 bytes and
+	an illegal digit at each position (including a missing last digit) are
+	used. Each input is placed at the end of an allocated block, so that
+	-fsanitize=address detects a read beyond the input.
+
+	hex_test
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define BYTE_MAX 300
+
+uint64_t rnd_state = 88172645463325252ULL;
+
+uint64_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 7;
+	rnd_state ^= rnd_state << 17;
+	return rnd_state;
+}
+
+/* chars next to the legal hex digits and chars, which are hex digits after "|0x20" or with bit 7 */
+const char illegal_list[] = "/:@G`g \x10\xb0\xc1\xe1\xff";
+
+int getDigit(int c)
+{
+	if ( c >= '0' && c <= '9' )
+		return c - '0';
+	if ( c >= 'a' && c <= 'f' )
+		return c - 'a' + 10;
+	if ( c >= 'A' && c <= 'F' )
+		return c - 'A' + 10;
+	return -1;
+}
+
+size_t refHexToMem(const char *s, size_t cnt, unsigned char *mem, unsigned long *sum)
+{
+	size_t i;
+	for( i = 0; i < cnt; i++ )
+	{
+		if ( getDigit((unsigned char)s[2*i]) < 0 || getDigit((unsigned char)s[2*i+1]) < 0 )
+			break;
+		mem[i] = (unsigned char)(getDigit((unsigned char)s[2*i]) * 16 + getDigit((unsigned char)s[2*i+1]));
+		*sum += mem[i];
+	}
+	return i;
+}
+
+/* compare coHexToMem() with the reference for hex string s (2*cnt chars), returns 1 if ok */
+int checkHex(const char *s, size_t cnt, int level)
+{
+	unsigned char ref[BYTE_MAX+16];
+	unsigned char mem[BYTE_MAX+16];
+	unsigned long ref_sum = 7, sum = 7;
+	size_t ref_n, n;
+	char *p = (char *)malloc(cnt > 0 ? 2*cnt : 1);	// exact size, for address sanitizer
+
+	if ( p == NULL )
+		return 0;
+	memcpy(p, s, 2*cnt);
+	memset(ref, 0xa5, sizeof(ref));
+	memset(mem, 0xa5, sizeof(mem));
+	ref_n = refHexToMem(s, cnt, ref, &ref_sum);
+	n = coHexToMem(p, cnt, mem, &sum);
+	free(p);
+	if ( n != ref_n || sum != ref_sum || memcmp(mem, ref, sizeof(mem)) != 0 )	// bytes after the illegal digit are not written
+	{
+		printf("level %d, cnt %lu: result %lu (expected %lu), sum %lu (expected %lu), s='%.*s'\n",
+			level, (unsigned long)cnt, (unsigned long)n, (unsigned long)ref_n, sum, ref_sum, (int)(2*cnt), s);
+		return 0;
+	}
+	return 1;
+}
+
+void testLevel(int level)
+{
+	const char digit_list[] = "0123456789abcdefABCDEF";
+	char s[2*BYTE_MAX+1];
+	unsigned char mem[BYTE_MAX];
+	size_t cnt, i, pos;
+	long err = 0;
+	char c;
+
+	for( cnt = 0; cnt <= BYTE_MAX && err < 10; cnt++ )
+	{
+		for( i = 0; i < 2*cnt; i++ )
+			s[i] = digit_list[rnd() % (sizeof(digit_list)-1)];
+		err += checkHex(s, cnt, level) == 0;
+		CHECK(coHexToMem(s, cnt, mem, NULL) == cnt);	// sum can be NULL
+
+		for( pos = 0; pos < 2*cnt && err < 10; pos++ )	// illegal digit at each position
+		{
+			c = s[pos];
+			s[pos] = illegal_list[rnd() % (sizeof(illegal_list)-1)];
+			err += checkHex(s, cnt, level) == 0;
+			s[pos] = c;
+		}
+		if ( cnt > 0 )	// odd number of digits: the last digit is missing
+		{
+			s[2*cnt-1] = '\0';
+			err += checkHex(s, cnt, level) == 0;
+		}
+	}
+	if ( err > 0 )
+		error_cnt++;
+}
+
+int main(void)
+{
+	int level, selected;
+	for( level = 0; level <= 2; level++ )
+	{
+		selected = coSetSIMD(level);
+		printf("coHexToMem level %d: %s\n", level, selected == level ? "tested" : "not available");
+		if ( selected == level )
+			testLevel(level);
+	}
+	coSetSIMD(2);
+	if ( error_cnt == 0 )
+		printf("hex_test ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}
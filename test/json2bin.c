@@ -0,0 +1,191 @@
+/*
+
+	json2bin
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	convert between JSON and the binary co format (coWriteBinary())
+
+	json2bin in.json out.bin		JSON to binary
+	json2bin -d in.bin out.json		binary to JSON
+	json2bin -b in.json [repeat]		compare the read speed of JSON and binary
+
+	Input files might be gzip compressed.
+
+	Errorlevel:
+		0		all good
+		1		wrong commandline
+		2		file or memory error
+		3		benchmark: JSON and binary result are different
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "co.h"
+
+uint64_t getEpochMicroseconds(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64_t)(tv.tv_sec) * 1000000 + (uint64_t)(tv.tv_usec);
+}
+
+/* read the complete file into memory, the result must be free'd */
+char *readFile(const char *name, size_t *len)
+{
+	FILE *fp;
+	char *mem = NULL;
+	char buf[4096];
+	size_t n;
+	size_t size = 0;
+	char *p;
+
+	fp = fopen(name, "rb");
+	if ( fp == NULL )
+		return perror(name), NULL;
+	while( (n = fread(buf, 1, sizeof(buf), fp)) > 0 )
+	{
+		p = (char *)realloc(mem, size + n + 1);
+		if ( p == NULL )
+			return fclose(fp), free(mem), NULL;
+		mem = p;
+		memcpy(mem + size, buf, n);
+		size += n;
+	}
+	fclose(fp);
+	if ( mem == NULL )
+		return NULL;
+	mem[size] = '\0';
+	*len = size;
+	return mem;
+}
+
+int benchmark(const char *name, int repeat)
+{
+	size_t json_len, bin_len;
+	char *json = readFile(name, &json_len);
+	char *bin;
+	char *json_out1, *json_out2;
+	co o;
+	int i;
+	uint64_t t0, t_json = 0, t_bin = 0, t_json_arena = 0, t_bin_arena = 0;
+	coArena a;
+	int result = 0;
+
+	if ( json == NULL )
+		return 2;
+	o = coReadJSONByString(json);
+	if ( o == NULL )
+		return free(json), 2;
+	bin = coWriteBinaryToMem(o, &bin_len);
+	coDelete(o);
+	if ( bin == NULL )
+		return free(json), 2;
+
+	/* measure the read time only, coDelete() is identical for both objects */
+	for( i = 0; i < repeat; i++ )
+	{
+		t0 = getEpochMicroseconds();
+		o = coReadJSONByString(json);
+		t_json += getEpochMicroseconds() - t0;
+		coDelete(o);
+		t0 = getEpochMicroseconds();
+		o = coReadBinaryByMem(bin, bin_len);
+		t_bin += getEpochMicroseconds() - t0;
+		coDelete(o);
+
+		a = coNewArena(0);
+		t0 = getEpochMicroseconds();
+		coReadJSONByStringWithArena(json, a);
+		t_json_arena += getEpochMicroseconds() - t0;
+		coDeleteArena(a);
+		a = coNewArena(0);
+		t0 = getEpochMicroseconds();
+		coReadBinaryByMemWithArena(bin, bin_len, a);
+		t_bin_arena += getEpochMicroseconds() - t0;
+		coDeleteArena(a);
+	}
+
+	printf("JSON:   %zu bytes, %llu ms\n", json_len, (unsigned long long)(t_json/1000));
+	printf("binary: %zu bytes, %llu ms\n", bin_len, (unsigned long long)(t_bin/1000));
+	printf("JSON with arena:   %llu ms\n", (unsigned long long)(t_json_arena/1000));
+	printf("binary with arena: %llu ms\n", (unsigned long long)(t_bin_arena/1000));
+
+	/* both objects must produce the same JSON output */
+	o = coReadJSONByString(json);
+	json_out1 = coWriteJSONToString(o, 1, 1);
+	coDelete(o);
+	o = coReadBinaryByMem(bin, bin_len);
+	json_out2 = coWriteJSONToString(o, 1, 1);
+	coDelete(o);
+	if ( json_out1 == NULL || json_out2 == NULL )
+		result = 2;
+	else if ( strcmp(json_out1, json_out2) != 0 )
+	{
+		puts("JSON and binary result are different");
+		result = 3;
+	}
+	free(json_out1);
+	free(json_out2);
+	free(bin);
+	free(json);
+	return result;
+}
+
+int main(int argc, char **argv)
+{
+	co o;
+	FILE *infp;
+	FILE *outfp;
+	int is_decode = 0;
+	int is_ok;
+
+	if ( argc >= 3 && strcmp(argv[1], "-b") == 0 )
+		return benchmark(argv[2], argc >= 4 ? atoi(argv[3]) : 10);
+	if ( argc == 4 && strcmp(argv[1], "-d") == 0 )
+	{
+		is_decode = 1;
+		argv++;
+		argc--;
+	}
+	if ( argc != 3 )
+	{
+		printf("%s in.json out.bin\n", argv[0]);
+		printf("%s -d in.bin out.json\n", argv[0]);
+		printf("%s -b in.json [repeat]\n", argv[0]);
+		return 1;
+	}
+
+	infp = fopen(argv[1], "rb");
+	if ( infp == NULL )
+		return perror(argv[1]), 2;
+	if ( is_decode )
+		o = coReadBinaryByFP(infp);
+	else
+		o = coReadJSONByFP(infp);
+	fclose(infp);
+	if ( o == NULL )
+		return 2;
+
+	outfp = fopen(argv[2], "wb");
+	if ( outfp == NULL )
+		return perror(argv[2]), coDelete(o), 2;
+	if ( is_decode )
+	{
+		coWriteJSON(o, 0, 1, outfp);
+		is_ok = 1;
+	}
+	else
+	{
+		is_ok = coWriteBinary(o, outfp);
+	}
+	if ( fclose(outfp) != 0 )
+		is_ok = 0;
+	coDelete(o);
+	return is_ok ? 0 : 2;
+}
@@ -0,0 +1,153 @@
+/*
+
+	json_dbl_bench
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	benchmark for the JSON number parser:
+	number heavy JSON arrays (integer, short decimal and full precision
+	numbers) are created and parsed with coReadJSONByString(). Each parsed
+	number is compared with the strtod() result.
+
+	json_dbl_bench [-n count] [-r repeat]
+
+	Errorlevel:
+		0		all numbers are identical to strtod()
+		1		some numbers are different
+		2		some error has happend (wrong commandline, memory allocation)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+uint64_t rnd_state = 88172645463325252ULL;
+
+uint64_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 7;
+	rnd_state ^= rnd_state << 17;
+	return rnd_state;
+}
+
+/* create a JSON array with "cnt" numbers, kind: 0=integer, 1=short decimal, 2=full precision */
+char *createJSON(long cnt, int kind)
+{
+	char *s = (char *)malloc(cnt*32+16);
+	char *p = s;
+	long i;
+	double d;
+	uint64_t b;
+	if ( s == NULL )
+		return NULL;
+	*p++ = '[';
+	for( i = 0; i < cnt; i++ )
+	{
+		if ( i > 0 )
+			*p++ = ',';
+		if ( kind == 0 )
+			p += sprintf(p, "%ld", (long)(rnd() % 2000000) - 1000000);
+		else if ( kind == 1 )
+			p += sprintf(p, "%ld.%02d", (long)(rnd() % 100000), (int)(rnd() % 100));
+		else
+		{
+			do
+			{
+				b = rnd();
+				memcpy(&d, &b, sizeof(double));
+			} while( d != d || d-d != 0.0 );	// skip nan and inf
+			p += sprintf(p, "%.17g", d);
+		}
+	}
+	*p++ = ']';
+	*p = '\0';
+	return s;
+}
+
+/* compare all numbers of the array with strtod(), return the number of differences */
+long checkNumbers(const char *json, cco o)
+{
+	long i, cnt = coVectorSize(o);
+	long err = 0;
+	const char *p = json+1;
+	char *end;
+	double d, e;
+	for( i = 0; i < cnt; i++ )
+	{
+		d = strtod(p, &end);
+		e = coDblGet(coVectorGet(o, i));
+		if ( memcmp(&d, &e, sizeof(double)) != 0 )
+			err++;
+		p = end + 1;
+	}
+	return err;
+}
+
+int main(int argc, char **argv)
+{
+	static const char *kind_name[3] = { "integer", "short decimal", "full precision" };
+	long cnt = 1000000;
+	int repeat = 5;
+	int kind, r;
+	long err = 0;
+	char *json;
+	co o;
+	uint64_t start, ms;
+
+	argv++;
+	while( *argv != NULL )
+	{
+		if ( strcmp(*argv, "-n") == 0 && argv[1] != NULL )
+		{
+			cnt = atol(argv[1]);
+			argv += 2;
+		}
+		else if ( strcmp(*argv, "-r") == 0 && argv[1] != NULL )
+		{
+			repeat = atoi(argv[1]);
+			argv += 2;
+		}
+		else
+		{
+			printf("json_dbl_bench [-n count] [-r repeat]\n");
+			printf("  -n <n>    numbers per array (default 1000000)\n");
+			printf("  -r <n>    number of times, each array is parsed (default 5)\n");
+			return 2;
+		}
+	}
+	if ( cnt < 1 || repeat < 1 )
+		return 2;
+
+	for( kind = 0; kind < 3; kind++ )
+	{
+		json = createJSON(cnt, kind);
+		if ( json == NULL )
+			return 2;
+		o = NULL;
+		start = getEpochMilliseconds();
+		for( r = 0; r < repeat; r++ )
+		{
+			coDelete(o);
+			o = coReadJSONByString(json);
+		}
+		ms = getEpochMilliseconds()-start;
+		if ( o == NULL || coVectorSize(o) != cnt )
+		{
+			printf("parse error\n");
+			return 2;
+		}
+		err += checkNumbers(json, o);
+		printf("%-15s numbers=%ld bytes=%lu milliseconds=%lu MB/s=%.1f\n", kind_name[kind], cnt*repeat, 
+			(unsigned long)strlen(json)*repeat, (unsigned long)ms, ms == 0 ? 0.0 : (double)strlen(json)*repeat/ms/1000.0);
+		coDelete(o);
+		free(json);
+	}
+	printf("differences to strtod(): %ld\n", err);
+	return err == 0 ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+/*
+
+	json_events
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	test for the JSON event interface:
+	- event order and depth for a fixed JSON string
+	- abort by the callback at each event: no further events, result is 0
+	- CO_JSON_MATERIALIZE: the START event is followed by CO_JSON_OBJECT
+	  instead of the content and the END event
+	- malformed JSON: result is 0
+	- for each file: the tree, which is built from the events, is identical
+	  to the tree from coReadJSONByFP()
+
+	json_events [file.json ...]
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+		2		some error has happend (read error, memory allocation)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define STACK_MAX 256
+
+/*===================================================================*/
+/* event trace */
+
+struct trace_struct
+{
+	char buf[1024];
+	int cnt;	// number of events so far
+	int abort_at;	// return CO_JSON_ABORT for this event (1, 2, ...), 0: never
+	int materialize_depth;	// return CO_JSON_MATERIALIZE for maps and arrays at this depth, -1: never
+	int error;	// some event after the abort event
+};
+
+/* append "<depth><event>" to the trace buffer */
+int traceCB(const struct co_json_event_struct *ev, void *data)
+{
+	struct trace_struct *t = (struct trace_struct *)data;
+	char *s = t->buf + strlen(t->buf);
+	char *json;
+
+	if ( t->abort_at > 0 && t->cnt >= t->abort_at )
+		t->error = 1;
+	if ( s > t->buf )
+		*s++ = ' ';
+	switch( ev->event )
+	{
+		case CO_JSON_START_MAP: sprintf(s, "%d{", ev->depth); break;
+		case CO_JSON_END_MAP: sprintf(s, "%d}", ev->depth); break;
+		case CO_JSON_START_ARRAY: sprintf(s, "%d[", ev->depth); break;
+		case CO_JSON_END_ARRAY: sprintf(s, "%d]", ev->depth); break;
+		case CO_JSON_KEY: sprintf(s, "%dK:%s", ev->depth, ev->str); break;
+		case CO_JSON_STR: sprintf(s, "%dS:%s", ev->depth, ev->str); break;
+		case CO_JSON_DBL: sprintf(s, "%dD:%g", ev->depth, ev->n); break;
+		case CO_JSON_BOOL: sprintf(s, "%dB:%g", ev->depth, ev->n); break;
+		case CO_JSON_NULL: sprintf(s, "%dN", ev->depth); break;
+		case CO_JSON_OBJECT:
+			json = coWriteJSONToString(ev->o, 1, 1);
+			sprintf(s, "%dO:%s", ev->depth, json != NULL ? json : "?");
+			free(json);
+			coDelete(ev->o);
+			break;
+		default: sprintf(s, "%d?", ev->depth); break;
+	}
+	t->cnt++;
+	if ( t->cnt == t->abort_at )
+		return CO_JSON_ABORT;
+	if ( ev->depth == t->materialize_depth && (ev->event == CO_JSON_START_MAP || ev->event == CO_JSON_START_ARRAY) )
+		return CO_JSON_MATERIALIZE;
+	return CO_JSON_CONTINUE;
+}
+
+const char *trace_json = "{\"a\":[1, \"x\", true, null, {\"b\":false}], \"c\":{}, \"d\":[[]], \"e\":-2.5}";
+
+const char *trace_expected =
+	"0{ 1K:a 1[ 2D:1 2S:x 2B:1 2N 2{ 3K:b 3B:0 2} 1] "
+	"1K:c 1{ 1} 1K:d 1[ 2[ 2] 1] 1K:e 1D:-2.5 0}";
+
+const char *materialize_expected =
+	"0{ 1K:a 1[ 1O:[1,\"x\",true,null,{\"b\":false}] "
+	"1K:c 1{ 1O:{} 1K:d 1[ 1O:[[]] 1K:e 1D:-2.5 0}";
+
+void initTrace(struct trace_struct *t, int abort_at, int materialize_depth)
+{
+	t->buf[0] = '\0';
+	t->cnt = 0;
+	t->abort_at = abort_at;
+	t->materialize_depth = materialize_depth;
+	t->error = 0;
+}
+
+void testTrace(void)
+{
+	struct trace_struct t;
+	int i, event_cnt;
+
+	/* event order and depth */
+	initTrace(&t, 0, -1);
+	CHECK(coReadJSONEventsByString(trace_json, traceCB, &t) != 0);
+	CHECK(strcmp(t.buf, trace_expected) == 0);
+	if ( strcmp(t.buf, trace_expected) != 0 )
+		printf("trace: %s\n", t.buf);
+	event_cnt = t.cnt;
+
+	/* abort at each event */
+	for( i = 1; i <= event_cnt; i++ )
+	{
+		initTrace(&t, i, -1);
+		CHECK(coReadJSONEventsByString(trace_json, traceCB, &t) == 0);
+		CHECK(t.cnt == i);
+		CHECK(t.error == 0);
+		CHECK(strncmp(t.buf, trace_expected, strlen(t.buf)) == 0);
+	}
+
+	/* materialize the values of the top level map */
+	initTrace(&t, 0, 1);
+	CHECK(coReadJSONEventsByString(trace_json, traceCB, &t) != 0);
+	CHECK(strcmp(t.buf, materialize_expected) == 0);
+	if ( strcmp(t.buf, materialize_expected) != 0 )
+		printf("materialize: %s\n", t.buf);
+
+	/* materialize the top level map */
+	initTrace(&t, 0, 0);
+	CHECK(coReadJSONEventsByString(trace_json, traceCB, &t) != 0);
+	CHECK(t.cnt == 2);
+	CHECK(strncmp(t.buf, "0{ 0O:{", 7) == 0);
+
+	/* top level values */
+	initTrace(&t, 0, -1);
+	CHECK(coReadJSONEventsByString("\"abc\"", traceCB, &t) != 0);
+	CHECK(strcmp(t.buf, "0S:abc") == 0);
+	initTrace(&t, 0, -1);
+	CHECK(coReadJSONEventsByString("[]", traceCB, &t) != 0);
+	CHECK(strcmp(t.buf, "0[ 0]") == 0);
+}
+
+void testMalformed(void)
+{
+	static const char *list[] = { "{\"a\":1", "[1,2", "{\"a\" 1}", "[1 2]", "{1:2}", NULL };
+	struct trace_struct t;
+	int i;
+	for( i = 0; list[i] != NULL; i++ )
+	{
+		initTrace(&t, 0, -1);
+		CHECK(coReadJSONEventsByString(list[i], traceCB, &t) == 0);
+	}
+}
+
+/*===================================================================*/
+/* build a tree from the events */
+
+struct build_struct
+{
+	co stack[STACK_MAX];	// open maps and arrays
+	char *key[STACK_MAX];	// pending key for each open map
+	int depth;	// number of open maps and arrays
+	co result;
+	int error;
+};
+
+/* add o to the current map/array or use o as result, returns 0 for error */
+int buildAdd(struct build_struct *b, co o)
+{
+	co parent;
+	if ( b->depth == 0 )
+	{
+		b->result = o;
+		return 1;
+	}
+	parent = b->stack[b->depth-1];
+	if ( coIsVector(parent) )
+		return coVectorAdd(parent, o) >= 0;
+	if ( b->key[b->depth-1] == NULL )
+		return 0;
+	if ( coMapAdd(parent, b->key[b->depth-1], o) == NULL )
+		return 0;
+	free(b->key[b->depth-1]);
+	b->key[b->depth-1] = NULL;
+	return 1;
+}
+
+int buildCB(const struct co_json_event_struct *ev, void *data)
+{
+	struct build_struct *b = (struct build_struct *)data;
+	co o = NULL;
+
+	switch( ev->event )
+	{
+		case CO_JSON_START_MAP:
+		case CO_JSON_START_ARRAY:
+			if ( b->depth >= STACK_MAX || b->depth != ev->depth )
+				return b->error = 1, CO_JSON_ABORT;
+			o = ev->event == CO_JSON_START_MAP ? coNewMap(CO_FREE_VALS|CO_STRDUP|CO_STRFREE) : coNewVector(CO_FREE_VALS);
+			if ( o == NULL || buildAdd(b, o) == 0 )
+				return b->error = 1, CO_JSON_ABORT;
+			b->stack[b->depth] = o;
+			b->key[b->depth] = NULL;
+			b->depth++;
+			return CO_JSON_CONTINUE;
+		case CO_JSON_END_MAP:
+		case CO_JSON_END_ARRAY:
+			if ( b->depth == 0 || b->depth-1 != ev->depth )
+				return b->error = 1, CO_JSON_ABORT;
+			b->depth--;
+			return CO_JSON_CONTINUE;
+		case CO_JSON_KEY:
+			if ( b->depth == 0 || b->depth != ev->depth || coIsMap(b->stack[b->depth-1]) == 0 )
+				return b->error = 1, CO_JSON_ABORT;
+			free(b->key[b->depth-1]);
+			b->key[b->depth-1] = strdup(ev->str);
+			return CO_JSON_CONTINUE;
+		case CO_JSON_STR: o = coNewStr(CO_STRDUP, ev->str); break;
+		case CO_JSON_DBL: o = coNewDbl(ev->n); break;
+		case CO_JSON_BOOL: o = coNewBool(ev->n != 0); break;
+		case CO_JSON_NULL: break;	// NULL element, same as coReadJSONByFP()
+		case CO_JSON_OBJECT: o = ev->o; break;
+		default:
+			return b->error = 1, CO_JSON_ABORT;
+	}
+	if ( b->depth != ev->depth || (ev->event != CO_JSON_NULL && o == NULL) )
+		return b->error = 1, coDelete(o), CO_JSON_ABORT;
+	if ( buildAdd(b, o) == 0 )
+		return b->error = 1, coDelete(o), CO_JSON_ABORT;
+	return CO_JSON_CONTINUE;
+}
+
+void initBuild(struct build_struct *b)
+{
+	b->depth = 0;
+	b->result = NULL;
+	b->error = 0;
+}
+
+void testFile(const char *name)
+{
+	FILE *fp;
+	co ref;
+	struct build_struct b;
+	int r;
+
+	fp = fopen(name, "rb");
+	if ( fp == NULL )
+	{
+		printf("read error: '%s'\n", name);
+		exit(2);
+	}
+	ref = coReadJSONByFP(fp);
+	if ( ref == NULL )
+	{
+		printf("read error or empty JSON: '%s'\n", name);
+		exit(2);
+	}
+
+	rewind(fp);
+	initBuild(&b);
+	r = coReadJSONEventsByFP(fp, buildCB, &b);
+	fclose(fp);
+	CHECK(r != 0);
+	CHECK(b.error == 0);
+	CHECK(b.depth == 0);
+	if ( isEqual(ref, b.result) == 0 )
+	{
+		printf("different tree for '%s'\n", name);
+		error_cnt++;
+	}
+	coDelete(b.result);
+	coDelete(ref);
+}
+
+void testBuild(void)
+{
+	struct build_struct b;
+	co ref = coReadJSONByString(trace_json);
+	CHECK(ref != NULL);
+	initBuild(&b);
+	CHECK(coReadJSONEventsByString(trace_json, buildCB, &b) != 0);
+	CHECK(b.error == 0);
+	CHECK(isEqual(ref, b.result));
+	coDelete(b.result);
+	coDelete(ref);
+}
+
+int main(int argc, char **argv)
+{
+	testTrace();
+	testMalformed();
+	testBuild();
+	argv++;
+	while( *argv != NULL )
+	{
+		testFile(*argv);
+		argv++;
+	}
+	printf("json_events: errors=%d\n", error_cnt);
+	return error_cnt > 0 ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+/*
+
+	json_mt
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	multithreaded stress test for the JSON parser:
+	all files are parsed once as reference, then each thread parses all files
+	"repeat" times (each thread starts with a different file) and compares the
+	result with the reference.
+
+	json_mt [-t threads] [-r repeat] file.json ...
+
+	Errorlevel:
+		0		all trees are identical
+		1		some trees are different
+		2		some error has happend (wrong commandline, read error, memory allocation)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define THREAD_MAX 64
+
+int file_cnt;
+char **file_list;
+co *reference_list;
+int repeat = 10;
+
+struct thread_struct
+{
+	pthread_t thread;
+	int index;
+	long parse_cnt;
+	long error_cnt;
+};
+
+co readJSON(const char *name)
+{
+	FILE *fp;
+	co o;
+	fp = fopen(name, "rb");
+	if ( fp == NULL )
+		return NULL;
+	o = coReadJSONByFP(fp);
+	fclose(fp);
+	return o;
+}
+
+void *parseThread(void *ptr)
+{
+	struct thread_struct *ts = (struct thread_struct *)ptr;
+	int r, i, f;
+	co o;
+	for( r = 0; r < repeat; r++ )
+	{
+		for( i = 0; i < file_cnt; i++ )
+		{
+			f = (ts->index + i) % file_cnt;	// each thread starts with a different file
+			o = readJSON(file_list[f]);
+			ts->parse_cnt++;
+			if ( isEqual(o, reference_list[f]) == 0 )
+			{
+				printf("thread %d: different tree for '%s'\n", ts->index, file_list[f]);
+				ts->error_cnt++;
+			}
+			coDelete(o);
+		}
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	struct thread_struct ts[THREAD_MAX];
+	int thread_cnt = 4;
+	int i;
+	long parse_cnt = 0;
+	long error_cnt = 0;
+	uint64_t start;
+
+	argv++;
+	while( *argv != NULL && (*argv)[0] == '-' )
+	{
+		if ( strcmp(*argv, "-t") == 0 && argv[1] != NULL )
+		{
+			thread_cnt = atoi(argv[1]);
+			argv += 2;
+		}
+		else if ( strcmp(*argv, "-r") == 0 && argv[1] != NULL )
+		{
+			repeat = atoi(argv[1]);
+			argv += 2;
+		}
+		else
+			break;
+	}
+	if ( *argv == NULL || thread_cnt < 1 || thread_cnt > THREAD_MAX )
+	{
+		printf("json_mt [-t threads] [-r repeat] file.json ...\n");
+		printf("  -t <n>    number of threads (1..%d, default 4)\n", THREAD_MAX);
+		printf("  -r <n>    number of times, each thread parses all files (default 10)\n");
+		return 2;
+	}
+
+	file_list = argv;
+	file_cnt = 0;
+	while( argv[file_cnt] != NULL )
+		file_cnt++;
+
+	reference_list = (co *)malloc(file_cnt*sizeof(co));
+	if ( reference_list == NULL )
+		return 2;
+	for( i = 0; i < file_cnt; i++ )
+	{
+		reference_list[i] = readJSON(file_list[i]);
+		if ( reference_list[i] == NULL )
+		{
+			printf("read error or empty JSON: '%s'\n", file_list[i]);
+			return 2;
+		}
+	}
+
+	start = getEpochMilliseconds();
+	for( i = 0; i < thread_cnt; i++ )
+	{
+		ts[i].index = i;
+		ts[i].parse_cnt = 0;
+		ts[i].error_cnt = 0;
+		if ( pthread_create( &(ts[i].thread), NULL, parseThread, (void*)(ts+i)) != 0 )
+		{
+			printf("thread create error\n");
+			return 2;
+		}
+	}
+	for( i = 0; i < thread_cnt; i++ )
+	{
+		pthread_join( ts[i].thread, NULL);
+		parse_cnt += ts[i].parse_cnt;
+		error_cnt += ts[i].error_cnt;
+	}
+	printf("threads=%d parsed files=%ld errors=%ld milliseconds=%lu\n", thread_cnt, parse_cnt, error_cnt, (unsigned long)(getEpochMilliseconds()-start));
+
+	for( i = 0; i < file_cnt; i++ )
+		coDelete(reference_list[i]);
+	free(reference_list);
+	return error_cnt == 0 ? 0 : 1;
+}
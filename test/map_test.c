@@ -0,0 +1,362 @@
+/*
+
+	map_test
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	test for the map (coNewMap()) and the hash map (coNewHashMap()):
+	- random insert, erase and lookup, compared with a reference array
+	- coMapSize(), coHashMapSize(), coMapGetByIndex(), coMapGetKeyByIndex(),
+	  coMapIndexOfKey() and the AVL tree invariants (height, subtree size)
+	  after deletions, which require rotations
+	- hash map insertion order (coHashMapForEach()) and sorted order
+	  (coHashMapSortedForEach())
+	- hash map resize with memory errors (malloc/realloc fault injection,
+	  link with -Wl,--wrap=malloc -Wl,--wrap=realloc)
+
+	map_test [-r ops]
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define KEY_CNT 1500
+
+uint64_t rnd_state = 88172645463325252ULL;
+
+uint64_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 7;
+	rnd_state ^= rnd_state << 17;
+	return rnd_state;
+}
+
+/*===================================================================*/
+/* malloc/realloc fault injection */
+
+void *__real_malloc(size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+long fail_countdown = 0;	// 0: disabled, n: the n-th call fails
+
+int isFail(void)
+{
+	if ( fail_countdown == 0 )
+		return 0;
+	fail_countdown--;
+	return fail_countdown == 0;
+}
+
+void *__wrap_malloc(size_t size)
+{
+	if ( isFail() )
+		return NULL;
+	return __real_malloc(size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	if ( isFail() )
+		return NULL;
+	return __real_realloc(ptr, size);
+}
+
+/*===================================================================*/
+/* reference */
+
+char key_list[KEY_CNT][16];	// key_list is sorted (fixed width)
+int is_present[KEY_CNT];
+double value_list[KEY_CNT];
+long insert_nr[KEY_CNT];		// insertion order of the hash map (replace keeps the order)
+long insert_cnt = 0;
+long present_cnt = 0;
+
+void initReference(void)
+{
+	int i;
+	for( i = 0; i < KEY_CNT; i++ )
+	{
+		sprintf(key_list[i], "key%06d", i);
+		is_present[i] = 0;
+	}
+	present_cnt = 0;
+}
+
+/* number of present keys before key_list[k] */
+long getRank(int k)
+{
+	long i, rank = 0;
+	for( i = 0; i < k; i++ )
+		rank += is_present[i];
+	return rank;
+}
+
+/* return the height of the AVL (sub)tree or -1 if the tree is not balanced or the size is wrong */
+int getAVLHeight(const struct co_avl_node_struct *n)
+{
+	int h0, h1;
+	if ( n->size == 0 )	// internal nil node
+		return 0;
+	h0 = getAVLHeight(n->kid[0]);
+	h1 = getAVLHeight(n->kid[1]);
+	if ( h0 < 0 || h1 < 0 || h0 - h1 > 1 || h1 - h0 > 1 )
+		return -1;
+	if ( n->size != 1 + n->kid[0]->size + n->kid[1]->size || n->height != 1 + (h0 > h1 ? h0 : h1) )
+		return -1;
+	return n->height;
+}
+
+struct order_struct
+{
+	long prev;	// insertion number of the previous key
+	int is_ok;
+};
+
+int orderCB(cco o, long idx, const char *key, cco value, void *data)
+{
+	struct order_struct *order = (struct order_struct *)data;
+	int k = atoi(key+3);
+	if ( k < 0 || k >= KEY_CNT || is_present[k] == 0 || insert_nr[k] <= order->prev || coDblGet(value) != value_list[k] )
+		order->is_ok = 0;
+	order->prev = insert_nr[k];
+	return 1;
+}
+
+int sortedCB(cco o, long idx, const char *key, cco value, void *data)
+{
+	struct order_struct *order = (struct order_struct *)data;
+	int k = atoi(key+3);
+	if ( k <= order->prev || getRank(k) != idx || coDblGet(value) != value_list[k] )
+		order->is_ok = 0;
+	order->prev = k;
+	return 1;
+}
+
+/* compare the complete map and hash map with the reference */
+void checkAll(cco m, cco h, int line)
+{
+	long i, idx;
+	struct order_struct order;
+	int is_ok = 1;
+	cco v;
+
+	if ( coMapSize(m) != present_cnt || coHashMapSize(h) != present_cnt )
+		printf("line %d: wrong size %ld %ld %ld\n", line, coMapSize(m), coHashMapSize(h), present_cnt), error_cnt++;
+	if ( getAVLHeight(m->m.root) < 0 )
+		printf("line %d: AVL tree is not balanced\n", line), error_cnt++;
+	for( i = 0, idx = 0; i < KEY_CNT; i++ )
+	{
+		if ( is_present[i] )
+		{
+			v = coMapGet(m, key_list[i]);
+			if ( v == NULL || coDblGet(v) != value_list[i] || coMapIndexOfKey(m, key_list[i]) != idx )
+				is_ok = 0;
+			if ( coMapGetKeyByIndex(m, idx) == NULL || strcmp(coMapGetKeyByIndex(m, idx), key_list[i]) != 0 || coMapGetByIndex(m, idx) != v )
+				is_ok = 0;
+			v = coHashMapGet(h, key_list[i]);
+			if ( v == NULL || coDblGet(v) != value_list[i] || coHashMapExists(h, key_list[i]) == 0 )
+				is_ok = 0;
+			idx++;
+		}
+		else
+		{
+			if ( coMapExists(m, key_list[i]) || coMapIndexOfKey(m, key_list[i]) != -1 || coHashMapExists(h, key_list[i]) || coHashMapGet(h, key_list[i]) != NULL )
+				is_ok = 0;
+		}
+	}
+	if ( coMapGetByIndex(m, -1) != NULL || coMapGetByIndex(m, present_cnt) != NULL || coMapGetKeyByIndex(m, present_cnt) != NULL )
+		is_ok = 0;
+	if ( is_ok == 0 )
+		printf("line %d: lookup or rank/select failed\n", line), error_cnt++;
+
+	order.prev = -1;
+	order.is_ok = 1;
+	coHashMapForEach(h, orderCB, &order);
+	if ( order.is_ok == 0 )
+		printf("line %d: wrong insertion order\n", line), error_cnt++;
+	order.prev = -1;
+	order.is_ok = 1;
+	coHashMapSortedForEach(h, sortedCB, &order);
+	if ( order.is_ok == 0 )
+		printf("line %d: wrong sorted order\n", line), error_cnt++;
+}
+
+/*===================================================================*/
+
+void add(co m, co h, int k, double value)
+{
+	CHECK(coMapAdd(m, key_list[k], coNewDbl(value)) != NULL);
+	CHECK(coHashMapAdd(h, key_list[k], coNewDbl(value)) != NULL);
+	if ( is_present[k] == 0 )
+	{
+		is_present[k] = 1;
+		insert_nr[k] = insert_cnt++;
+		present_cnt++;
+	}
+	value_list[k] = value;
+}
+
+void erase(co m, co h, int k)
+{
+	coMapErase(m, key_list[k]);
+	coHashMapErase(h, key_list[k]);
+	if ( is_present[k] )
+	{
+		is_present[k] = 0;
+		present_cnt--;
+	}
+}
+
+/* random insert, replace, erase and lookup */
+void testRandom(long ops)
+{
+	co m = coNewMap(CO_FREE_VALS|CO_STRDUP);
+	co h = coNewHashMap(CO_FREE_VALS|CO_STRDUP);
+	long i;
+	int k;
+	cco v;
+
+	initReference();
+	for( i = 0; i < ops; i++ )
+	{
+		k = (int)(rnd() % KEY_CNT);
+		switch( rnd() % 4 )
+		{
+			case 0:
+			case 1:
+				add(m, h, k, (double)i);
+				break;
+			case 2:
+				erase(m, h, k);
+				break;
+			default:
+				v = coMapGet(m, key_list[k]);
+				if ( (is_present[k] ? v == NULL || coDblGet(v) != value_list[k] : v != NULL) )
+					printf("coMapGet failed for %s\n", key_list[k]), error_cnt++;
+				v = coHashMapGet(h, key_list[k]);
+				if ( (is_present[k] ? v == NULL || coDblGet(v) != value_list[k] : v != NULL) )
+					printf("coHashMapGet failed for %s\n", key_list[k]), error_cnt++;
+				break;
+		}
+		if ( coMapSize(m) != present_cnt || coHashMapSize(h) != present_cnt )
+		{
+			printf("op %ld: wrong size\n", i), error_cnt++;
+			break;
+		}
+		if ( i % 5000 == 0 )
+			checkAll(m, h, __LINE__);
+	}
+	checkAll(m, h, __LINE__);
+
+	// erase all keys
+	for( k = 0; k < KEY_CNT; k++ )
+		erase(m, h, k);
+	checkAll(m, h, __LINE__);
+	CHECK(coMapEmpty(m) && coHashMapEmpty(h));
+	coDelete(m);
+	coDelete(h);
+}
+
+/*
+  insert the keys in sorted order and erase them in an order, which
+  requires rotations, check rank/select after each deletion
+*/
+void testRebalance(void)
+{
+	co m = coNewMap(CO_FREE_VALS|CO_STRDUP);
+	co h = coNewHashMap(CO_FREE_VALS|CO_STRDUP);
+	co c;
+	int k, cnt = 300;
+
+	initReference();
+	for( k = 0; k < cnt; k++ )
+		add(m, h, k, k);
+	checkAll(m, h, __LINE__);
+	for( k = 0; k < cnt; k += 2 )		// every second key: holes in the left and right subtrees
+		erase(m, h, k), checkAll(m, h, __LINE__);
+	for( k = cnt-1; k >= cnt/2; k -= 2 )	// remove the right half: the tree must rotate to the right
+		erase(m, h, k), checkAll(m, h, __LINE__);
+	for( k = 0; k < cnt; k += 3 )		// insert again between the remaining keys
+		add(m, h, k, -k), checkAll(m, h, __LINE__);
+	c = coClone(m);
+	CHECK(isEqual(m, c));
+	coDelete(c);
+	coDelete(m);
+	coDelete(h);
+}
+
+/*
+  memory errors during the resize of the hash map must not change the hash
+  map, erased keys leave holes, which are removed by the resize
+*/
+void testResizeFailure(void)
+{
+	co h;
+	co v;
+	int n, k, is_ok, is_error;
+	for( n = 1; n < 40; n++ )
+	{
+		h = coNewHashMap(CO_FREE_VALS);	// no CO_STRDUP: strdup() would allocate inside the C library
+		initReference();
+		is_error = 0;
+		fail_countdown = n;
+		for( k = 0; k < 200 && is_error == 0; k++ )
+		{
+			v = coNewDbl(k);
+			if ( v == NULL )
+				break;
+			if ( coHashMapAdd(h, key_list[k], v) == NULL )
+			{
+				coDelete(v);
+				is_error = 1;
+				break;
+			}
+			is_present[k] = 1;
+			present_cnt++;
+			if ( k % 4 == 3 )
+			{
+				coHashMapErase(h, key_list[k-2]);
+				is_present[k-2] = 0;
+				present_cnt--;
+			}
+		}
+		fail_countdown = 0;
+		is_ok = coHashMapSize(h) == present_cnt;
+		for( k = 0; k < 200; k++ )
+			if ( (coHashMapGet(h, key_list[k]) != NULL) != is_present[k] )
+				is_ok = 0;
+		for( k = 0; k < 200; k++ )	// continue without memory error
+			if ( is_present[k] == 0 && coHashMapAdd(h, key_list[k], coNewDbl(k)) == NULL )
+				is_ok = 0;
+		for( k = 0; k < 200; k++ )
+			if ( coHashMapGet(h, key_list[k]) == NULL || coDblGet(coHashMapGet(h, key_list[k])) != k )
+				is_ok = 0;
+		if ( is_ok == 0 || coHashMapSize(h) != 200 )
+			printf("resize failure: allocation %d failed, hash map is corrupted\n", n), error_cnt++;
+		coDelete(h);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	long ops = 200000;
+	if ( argc >= 3 && strcmp(argv[1], "-r") == 0 )
+		ops = atol(argv[2]);
+	testRandom(ops);
+	testRebalance();
+	testResizeFailure();
+	if ( error_cnt == 0 )
+		printf("map_test ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/*
+
+	mem_test
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	test for the backing store of memory blocks (coMem and coMemImage):
+	coMemAdd(), coMemReserve(), coMemShrink(), coMemImageAdd(),
+	coMemImageReserve() and coMemImageShrink() with blocks, which cross
+	the mmap threshold (4MB) in both directions: malloc to mmap, mmap to
+	mmap (mremap) and mmap back to malloc. The content must be preserved
+	in all cases. Run with -fsanitize=address to detect a free() of a
+	mapped block.
+
+	mem_test
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define MB (1024*1024)
+
+/* test pattern, pos is the position inside the block */
+unsigned char getByte(size_t pos)
+{
+	return (unsigned char)(pos * 7 + (pos >> 13));
+}
+
+/* add len bytes of the test pattern to o, chunk sizes vary between 1 and 100000 bytes */
+int addPattern(co o, size_t len)
+{
+	static unsigned char buf[100000];
+	size_t pos = coMemSize(o);
+	size_t end = pos + len;
+	size_t n, i, step = 1;
+	while( pos < end )
+	{
+		n = end - pos;
+		if ( n > step )
+			n = step;
+		for( i = 0; i < n; i++ )
+			buf[i] = getByte(pos + i);
+		if ( coMemAdd(o, buf, n) == 0 )
+			return 0;
+		pos += n;
+		step = step * 3 + 1;
+		if ( step > sizeof(buf) )
+			step = 1;
+	}
+	return 1;
+}
+
+/* return 1 if the memory object contains the test pattern */
+int isPattern(cco o, size_t len)
+{
+	const unsigned char *p = (const unsigned char *)coMemGet(o);
+	size_t i;
+	if ( (size_t)coMemSize(o) != len )
+		return 0;
+	for( i = 0; i < len; i++ )
+		if ( p[i] != getByte(i) )
+			return 0;
+	return 1;
+}
+
+void testMem(void)
+{
+	co o = coNewMem();
+	co c;
+
+	/* malloc -> mmap -> mremap (grow) */
+	CHECK(addPattern(o, 100000));
+	CHECK(coMemReserve(o, 5*MB));			// malloc to mmap
+	CHECK(o->s.memlen == 5*MB && isPattern(o, 100000));
+	CHECK(addPattern(o, 3*MB));
+	CHECK(coMemReserve(o, 20*MB));			// mmap to mmap
+	CHECK(o->s.memlen == 20*MB && isPattern(o, 100000 + 3*MB));
+	CHECK(coMemReserve(o, 1*MB));			// no change
+	CHECK(o->s.memlen == 20*MB);
+	CHECK(addPattern(o, 3*MB));
+	CHECK(coMemShrink(o));					// mremap (shrink), 6MB are still mapped
+	CHECK(o->s.memlen == 100000 + 6*MB && isPattern(o, 100000 + 6*MB));
+	CHECK(addPattern(o, 1000));				// grow after shrink
+	CHECK(isPattern(o, 100000 + 6*MB + 1000));
+	c = coClone(o);
+	CHECK(isEqual(o, c));
+	coDelete(c);
+	coDelete(o);
+
+	/* mmap -> malloc */
+	o = coNewMem();
+	CHECK(addPattern(o, 2*MB));
+	CHECK(coMemReserve(o, 8*MB));
+	CHECK(coMemShrink(o));					// mmap to malloc
+	CHECK(o->s.memlen == 2*MB && isPattern(o, 2*MB));
+	CHECK(addPattern(o, 3*MB));				// malloc to mmap by coMemAdd()
+	CHECK(isPattern(o, 5*MB));
+	CHECK(coMemShrink(o));
+	CHECK(o->s.memlen == 5*MB && isPattern(o, 5*MB));
+	coDelete(o);
+
+	/* coMemAdd() only: the block grows across the threshold */
+	o = coNewMem();
+	CHECK(addPattern(o, 12*MB + 3));
+	CHECK(isPattern(o, 12*MB + 3));
+	CHECK(coMemShrink(o));
+	CHECK(isPattern(o, 12*MB + 3));
+	coDelete(o);
+
+	/* empty mapped block */
+	o = coNewMem();
+	CHECK(coMemReserve(o, 6*MB));
+	CHECK(coMemShrink(o));
+	CHECK(coMemSize(o) == 0 && o->s.memlen == 0);
+	CHECK(addPattern(o, 10));
+	CHECK(isPattern(o, 10));
+	coDelete(o);
+}
+
+/* return 1 if the block starts at address and has the test pattern */
+int isBlockPattern(const struct co_mem_block_struct *b, uint64_t address, size_t len)
+{
+	size_t i;
+	if ( b == NULL || b->address != address || b->len != len )
+		return 0;
+	for( i = 0; i < len; i++ )
+		if ( b->data[i] != getByte((size_t)address + i) )
+			return 0;
+	return 1;
+}
+
+void testMemImage(void)
+{
+	co o = coNewMemImage();
+	co c;
+	unsigned char buf[4096];
+	uint64_t address;
+	size_t i;
+
+	/* blocks at 0 and at 64MB, both grow across the threshold */
+	for( address = 0; address < 10*MB; address += sizeof(buf) )
+	{
+		for( i = 0; i < sizeof(buf); i++ )
+			buf[i] = getByte((size_t)address + i);
+		CHECK(coMemImageAdd(o, address, buf, sizeof(buf)));
+		CHECK(coMemImageAdd(o, 64*MB + address, buf, sizeof(buf)));	// getByte(64MB+x) == getByte(x)
+	}
+	CHECK(coMemImageSize(o) == 2);
+	CHECK(isBlockPattern(coMemImageGetBlock(o, 0), 0, 10*MB));
+	CHECK(isBlockPattern(coMemImageGetBlock(o, 1), 64*MB, 10*MB));
+	CHECK(coMemImageReserve(o, 0, 30*MB));		// mremap
+	CHECK(coMemImageGetBlock(o, 0)->memlen >= 30*MB);
+	CHECK(coMemImageShrink(o));
+	CHECK(coMemImageGetBlock(o, 0)->memlen == 10*MB);
+	CHECK(isBlockPattern(coMemImageGetBlock(o, 0), 0, 10*MB));
+	c = coClone(o);
+	CHECK(isEqual(o, c));
+	coDelete(c);
+	coDelete(o);
+
+	/* small block with a large reservation: mmap back to malloc */
+	o = coNewMemImage();
+	for( i = 0; i < sizeof(buf); i++ )
+		buf[i] = getByte(0x1000 + i);
+	CHECK(coMemImageAdd(o, 0x1000, buf, sizeof(buf)));
+	CHECK(coMemImageReserve(o, 0x1000, 5*MB));
+	CHECK(coMemImageGetBlock(o, 0)->memlen >= 5*MB);
+	CHECK(coMemImageShrink(o));
+	CHECK(coMemImageGetBlock(o, 0)->memlen == sizeof(buf));
+	CHECK(isBlockPattern(coMemImageGetBlock(o, 0), 0x1000, sizeof(buf)));
+	coDelete(o);
+}
+
+int main(void)
+{
+	testMem();
+	testMemImage();
+	if ( error_cnt == 0 )
+		printf("mem_test ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+/*
+
+	s19_bench
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	benchmark for the S19 and HEX reader: measure the overhead of the
+	checksum verification (CO_READ_CHECKSUM).
+	Without file argument, a temporary S19 file with random data is created.
+
+	s19_bench [-s size_in_mb] [-r repeat] [file.s19|file.hex]
+
+	Errorlevel:
+		0		all good
+		1		read error (e.g. checksum error)
+		2		some error has happend (wrong commandline, memory allocation)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "co.h"
+#include "co_test_util.h"
+
+uint64_t rnd_state = 88172645463325252ULL;
+
+uint64_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 7;
+	rnd_state ^= rnd_state << 17;
+	return rnd_state;
+}
+
+/* create a temporary S19 file with S3 records (32 data bytes each) and at least "size" bytes */
+FILE *createS19(size_t size)
+{
+	FILE *fp = tmpfile();
+	unsigned char rec[40];
+	size_t total = 0;
+	unsigned long address = 0x80000000UL;
+	unsigned sum;
+	int i;
+	if ( fp == NULL )
+		return NULL;
+	while( total < size )
+	{
+		rec[0] = 32+5;
+		rec[1] = (address >> 24) & 255;
+		rec[2] = (address >> 16) & 255;
+		rec[3] = (address >> 8) & 255;
+		rec[4] = address & 255;
+		for( i = 0; i < 32; i++ )
+			rec[5+i] = rnd() & 255;
+		sum = 0;
+		fputs("S3", fp);
+		for( i = 0; i < 37; i++ )
+		{
+			sum += rec[i];
+			fprintf(fp, "%02X", rec[i]);
+		}
+		fprintf(fp, "%02X\n", (~sum) & 255);
+		total += 2+37*2+2+1;
+		address += 32;
+	}
+	rewind(fp);
+	return fp;
+}
+
+/* read the file and return the time in milliseconds, -1 for read error */
+long readFile(FILE *fp, int is_hex, unsigned flags)
+{
+	uint64_t t0;
+	long t;
+	co o;
+	rewind(fp);
+	t0 = getEpochMilliseconds();
+	if ( is_hex )
+		o = coReadHEXByFPWithFlags(fp, flags);
+	else
+		o = coReadS19ByFPWithFlags(fp, flags);
+	t = (long)(getEpochMilliseconds() - t0);
+	if ( o == NULL )
+		return -1;
+	coDelete(o);
+	return t;
+}
+
+int main(int argc, char **argv)
+{
+	size_t size = 100;
+	int repeat = 5;
+	const char *name = NULL;
+	FILE *fp;
+	int is_hex = 0;
+	int i;
+	long t, t_best = -1, t_check_best = -1;
+
+	for( i = 1; i < argc; i++ )
+	{
+		if ( strcmp(argv[i], "-s") == 0 && i+1 < argc )
+			size = (size_t)atol(argv[++i]);
+		else if ( strcmp(argv[i], "-r") == 0 && i+1 < argc )
+			repeat = atoi(argv[++i]);
+		else if ( argv[i][0] == '-' )
+			return printf("%s [-s size_in_mb] [-r repeat] [file.s19|file.hex]\n", argv[0]), 2;
+		else
+			name = argv[i];
+	}
+
+	if ( name != NULL )
+	{
+		fp = fopen(name, "rb");
+		if ( fp == NULL )
+			return perror(name), 2;
+		is_hex = strstr(name, ".hex") != NULL;
+	}
+	else
+	{
+		printf("creating %zu MB S19 file\n", size);
+		fp = createS19(size*1024*1024);
+		if ( fp == NULL )
+			return perror("tmpfile"), 2;
+	}
+
+	/* alternate both measurements, so that both see the same system state */
+	for( i = 0; i < repeat; i++ )
+	{
+		t = readFile(fp, is_hex, CO_READ_MEM_IMAGE);
+		if ( t < 0 )
+			return fclose(fp), puts("read error"), 1;
+		if ( t_best < 0 || t < t_best )
+			t_best = t;
+		t = readFile(fp, is_hex, CO_READ_MEM_IMAGE|CO_READ_CHECKSUM);
+		if ( t < 0 )
+			return fclose(fp), puts("read error with checksum verification"), 1;
+		if ( t_check_best < 0 || t < t_check_best )
+			t_check_best = t;
+	}
+	fclose(fp);
+
+	printf("without checksum: %ld ms\n", t_best);
+	printf("with checksum:    %ld ms\n", t_check_best);
+	if ( t_best > 0 )
+		printf("overhead:         %.1f%%\n", (double)(t_check_best - t_best)*100.0/(double)t_best);
+	return 0;
+}
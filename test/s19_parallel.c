@@ -0,0 +1,244 @@
+/*
+
+	s19_parallel
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	regression test for the parallel S19 reader:
+	each file is read with coReadS19ByFPWithFlags() and with
+	coReadS19ByFPParallel() (2 up to the given number of threads), with and
+	without CO_READ_MEM_IMAGE and CO_READ_CHECKSUM. All results must be
+	identical.
+	Additionally a generated S19 file is used:
+	- contiguous address ranges, which cross many chunk borders, must be
+	  merged into one block
+	- a checksum error must be reported with the same line number
+
+	s19_parallel [-t threads] [file.s19 ...]
+
+	Errorlevel:
+		0		all results are identical
+		1		some results are different
+		2		some error has happend (wrong commandline, read error)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define LINE_CNT 60000		/* about 4MB, the parallel reader uses 64K chunks at least */
+#define DATA_PER_LINE 32
+#define BAD_LINE 50001		/* line with checksum error (S0 record is line 1) */
+
+int thread_max = 8;
+
+/*
+  read fp with thread_cnt threads (1: serial reader), the output of the
+  reader (error messages) is stored in msg
+*/
+co readS19(FILE *fp, int thread_cnt, unsigned flags, char *msg, size_t msg_size)
+{
+	FILE *out = tmpfile();
+	int stdout_fd;
+	size_t n;
+	co o;
+
+	msg[0] = '\0';
+	if ( out == NULL )
+		return NULL;
+	fflush(stdout);
+	stdout_fd = dup(1);
+	dup2(fileno(out), 1);
+	rewind(fp);
+	if ( thread_cnt <= 1 )
+		o = coReadS19ByFPWithFlags(fp, flags);
+	else
+		o = coReadS19ByFPParallel(fp, thread_cnt, flags);
+	fflush(stdout);
+	dup2(stdout_fd, 1);
+	close(stdout_fd);
+	rewind(out);
+	n = fread(msg, 1, msg_size-1, out);
+	msg[n] = '\0';
+	fclose(out);
+	return o;
+}
+
+/* compare the serial and the parallel reader for all flags, returns the number of differences */
+int compareS19(FILE *fp, const char *name)
+{
+	static const unsigned flag_list[4] = { 0, CO_READ_MEM_IMAGE, CO_READ_CHECKSUM, CO_READ_MEM_IMAGE|CO_READ_CHECKSUM };
+	char ref_msg[256];
+	char msg[256];
+	int diff_cnt = 0;
+	int thread_cnt, i;
+	co reference;
+	co o;
+	uint64_t start;
+
+	for( i = 0; i < 4; i++ )
+	{
+		start = getEpochMilliseconds();
+		reference = readS19(fp, 1, flag_list[i], ref_msg, sizeof(ref_msg));
+		printf("%s flags=%u threads=1 milliseconds=%lu%s\n", name, flag_list[i], (unsigned long)(getEpochMilliseconds()-start), reference == NULL ? " read error" : "");
+		for( thread_cnt = 2; thread_cnt <= thread_max; thread_cnt++ )
+		{
+			start = getEpochMilliseconds();
+			o = readS19(fp, thread_cnt, flag_list[i], msg, sizeof(msg));
+			printf("%s flags=%u threads=%d milliseconds=%lu", name, flag_list[i], thread_cnt, (unsigned long)(getEpochMilliseconds()-start));
+			if ( isEqual(reference, o) && strcmp(ref_msg, msg) == 0 )
+			{
+				printf(" ok\n");
+			}
+			else
+			{
+				printf(" different result\n");
+				if ( strcmp(ref_msg, msg) != 0 )
+					printf("  serial: '%s' parallel: '%s'\n", ref_msg, msg);
+				diff_cnt++;
+			}
+			coDelete(o);
+		}
+		coDelete(reference);
+	}
+	return diff_cnt;
+}
+
+/* write one S3 record, the checksum is wrong if is_bad is not 0 */
+void writeS3(FILE *fp, unsigned long address, const unsigned char *data, int cnt, int is_bad)
+{
+	unsigned sum = cnt + 5;
+	int i;
+	fprintf(fp, "S3%02X%08lX", cnt + 5, address);
+	for( i = 0; i < 4; i++ )
+		sum += (address >> (i*8)) & 0xff;
+	for( i = 0; i < cnt; i++ )
+	{
+		fprintf(fp, "%02X", data[i]);
+		sum += data[i];
+	}
+	fprintf(fp, "%02X\n", (~sum + (is_bad ? 1 : 0)) & 0xff);
+}
+
+/*
+  generate a S19 file with three address ranges: two large contiguous ranges,
+  which cross many chunk borders, and a range before the first one (not
+  sorted). If bad_line is not 0, then this line has a wrong checksum.
+*/
+FILE *generateS19(long bad_line)
+{
+	FILE *fp = tmpfile();
+	unsigned char data[DATA_PER_LINE];
+	unsigned long address = 0x80000000UL;
+	long line_nr = 1;
+	int i;
+
+	if ( fp == NULL )
+		return NULL;
+	fprintf(fp, "S00600004844521B\n");
+	while( line_nr < LINE_CNT )
+	{
+		line_nr++;
+		for( i = 0; i < DATA_PER_LINE; i++ )
+			data[i] = (unsigned char)(line_nr*7 + i);
+		if ( line_nr == LINE_CNT/2 )
+			address += 0x1000;	// gap: start of the second range
+		if ( line_nr == LINE_CNT-10 )
+			address = 0x10000000UL;	// third range (last 11 lines), lower address
+		writeS3(fp, address, data, DATA_PER_LINE, line_nr == bad_line);
+		address += DATA_PER_LINE;
+	}
+	fprintf(fp, "S70500000000FA\n");
+	fflush(fp);
+	return fp;
+}
+
+void testGenerated(void)
+{
+	char msg[256];
+	char expected[256];
+	FILE *fp;
+	co o;
+
+	fp = generateS19(0);
+	if ( fp == NULL )
+	{
+		printf("tmpfile error\n");
+		exit(2);
+	}
+	error_cnt += compareS19(fp, "generated");
+
+	// the ranges must be merged across the chunk borders
+	o = readS19(fp, thread_max, CO_READ_MEM_IMAGE|CO_READ_CHECKSUM, msg, sizeof(msg));
+	if ( o == NULL || coMemImageSize(o) != 3 || coMemImageGetBlock(o, 0)->len != 11*DATA_PER_LINE )
+	{
+		printf("generated: memory image with 3 blocks expected\n");
+		error_cnt++;
+	}
+	coDelete(o);
+	o = readS19(fp, thread_max, CO_NONE, msg, sizeof(msg));
+	if ( o == NULL || coMapSize(o) != 3 )
+	{
+		printf("generated: map with 3 blocks expected\n");
+		error_cnt++;
+	}
+	coDelete(o);
+	fclose(fp);
+
+	// checksum error in a later chunk: same line number as the serial reader
+	fp = generateS19(BAD_LINE);
+	if ( fp == NULL )
+	{
+		printf("tmpfile error\n");
+		exit(2);
+	}
+	error_cnt += compareS19(fp, "generated with checksum error");
+	sprintf(expected, "checksum error in s19 file, line %d\n", BAD_LINE);
+	o = readS19(fp, thread_max, CO_READ_CHECKSUM, msg, sizeof(msg));
+	if ( o != NULL || strcmp(msg, expected) != 0 )
+	{
+		printf("generated: checksum error in line %d expected, reader output: '%s'\n", BAD_LINE, msg);
+		error_cnt++;
+	}
+	coDelete(o);
+	fclose(fp);
+}
+
+int main(int argc, char **argv)
+{
+	FILE *fp;
+
+	argv++;
+	if ( *argv != NULL && strcmp(*argv, "-t") == 0 && argv[1] != NULL )
+	{
+		thread_max = atoi(argv[1]);
+		argv += 2;
+	}
+	if ( thread_max < 2 || (*argv != NULL && (*argv)[0] == '-') )
+	{
+		printf("s19_parallel [-t threads] [file.s19 ...]\n");
+		printf("  -t <n>    maximum number of threads (2.., default 8)\n");
+		return 2;
+	}
+
+	testGenerated();
+	while( *argv != NULL )
+	{
+		fp = fopen(*argv, "rb");
+		if ( fp == NULL )
+		{
+			printf("read error: '%s'\n", *argv);
+			return 2;
+		}
+		error_cnt += compareS19(fp, *argv);
+		fclose(fp);
+		argv++;
+	}
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+/*
+
+	str_pool_mt
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	multithreaded test for the lock-free string pool (coNewStrPool()):
+	each thread adds the same list of strings "repeat" times to one pool (each
+	thread starts at a different position of the list). Afterwards:
+	- all threads must have received the same object for equal strings
+	- each object contains the added string (different strings have
+	  different objects), strings may contain '\0'
+	- coStrPoolSize() and coStrPoolGetStat() must match the number of
+	  distinct strings and coStrPoolAdd() calls
+
+	str_pool_mt [-t threads] [-r repeat] [-n strings]
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+		2		some error has happend (wrong commandline, memory allocation)
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "co.h"
+#include "co_test_util.h"
+
+#define THREAD_MAX 64
+
+co pool;
+long str_cnt = 100000;
+char **str_list;
+size_t *len_list;
+int repeat = 4;
+
+struct thread_struct
+{
+	pthread_t thread;
+	int index;
+	int thread_cnt;
+	cco *result;	// object for each string of str_list
+	long error_cnt;
+};
+
+/*
+  distinct strings: most strings are numbers, every 8th string has an
+  embedded '\0' and differs from another string only after the '\0'
+*/
+int createStrList(void)
+{
+	char buf[64];
+	long i;
+	str_list = (char **)malloc(str_cnt*sizeof(char *));
+	len_list = (size_t *)malloc(str_cnt*sizeof(size_t));
+	if ( str_list == NULL || len_list == NULL )
+		return 0;
+	for( i = 0; i < str_cnt; i++ )
+	{
+		if ( i % 8 == 7 )
+		{
+			len_list[i] = (size_t)sprintf(buf, "zero_%ld", i/16);
+			buf[4] = '\0';	// "zero\0<n>", the strings for i and i+8 have the same prefix
+			buf[len_list[i]++] = (char)('a' + i % 16 / 8);
+		}
+		else
+		{
+			len_list[i] = (size_t)sprintf(buf, "str%ld", i);
+		}
+		str_list[i] = (char *)malloc(len_list[i] + 1);
+		if ( str_list[i] == NULL )
+			return 0;
+		memcpy(str_list[i], buf, len_list[i]);
+		str_list[i][len_list[i]] = '\0';
+	}
+	return 1;
+}
+
+void *addThread(void *ptr)
+{
+	struct thread_struct *ts = (struct thread_struct *)ptr;
+	long start = str_cnt / ts->thread_cnt * ts->index;	// each thread starts at a different position
+	long i, j;
+	int r;
+	cco o;
+	for( r = 0; r < repeat; r++ )
+	{
+		for( j = 0; j < str_cnt; j++ )
+		{
+			i = (start + j) % str_cnt;
+			o = coStrPoolAdd(pool, str_list[i], len_list[i]);
+			if ( o == NULL )
+			{
+				ts->error_cnt++;
+				continue;
+			}
+			if ( r == 0 )
+				ts->result[i] = o;
+			else if ( ts->result[i] != o )	// same object for each call
+				ts->error_cnt++;
+		}
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	struct thread_struct ts[THREAD_MAX];
+	coStrPoolStat stat;
+	int thread_cnt = 4;
+	int t;
+	long i;
+	long error_cnt = 0;
+	size_t bytes = 0;
+	size_t call_cnt;
+	uint64_t start;
+
+	argv++;
+	while( *argv != NULL && (*argv)[0] == '-' )
+	{
+		if ( strcmp(*argv, "-t") == 0 && argv[1] != NULL )
+		{
+			thread_cnt = atoi(argv[1]);
+			argv += 2;
+		}
+		else if ( strcmp(*argv, "-r") == 0 && argv[1] != NULL )
+		{
+			repeat = atoi(argv[1]);
+			argv += 2;
+		}
+		else if ( strcmp(*argv, "-n") == 0 && argv[1] != NULL )
+		{
+			str_cnt = atol(argv[1]);
+			argv += 2;
+		}
+		else
+			break;
+	}
+	if ( *argv != NULL || thread_cnt < 1 || thread_cnt > THREAD_MAX || repeat < 1 || str_cnt < 16 )
+	{
+		printf("str_pool_mt [-t threads] [-r repeat] [-n strings]\n");
+		printf("  -t <n>    number of threads (1..%d, default 4)\n", THREAD_MAX);
+		printf("  -r <n>    number of times, each thread adds all strings (default 4)\n");
+		printf("  -n <n>    number of distinct strings (16.., default 100000)\n");
+		return 2;
+	}
+
+	pool = coNewStrPool();
+	if ( pool == NULL || createStrList() == 0 )
+		return 2;
+
+	start = getEpochMilliseconds();
+	for( t = 0; t < thread_cnt; t++ )
+	{
+		ts[t].index = t;
+		ts[t].thread_cnt = thread_cnt;
+		ts[t].error_cnt = 0;
+		ts[t].result = (cco *)calloc(str_cnt, sizeof(cco));
+		if ( ts[t].result == NULL )
+			return 2;
+		if ( pthread_create( &(ts[t].thread), NULL, addThread, (void*)(ts+t)) != 0 )
+		{
+			printf("thread create error\n");
+			return 2;
+		}
+	}
+	for( t = 0; t < thread_cnt; t++ )
+	{
+		pthread_join( ts[t].thread, NULL);
+		error_cnt += ts[t].error_cnt;
+	}
+	printf("threads=%d strings=%ld repeat=%d milliseconds=%lu\n", thread_cnt, str_cnt, repeat, (unsigned long)(getEpochMilliseconds()-start));
+	if ( error_cnt > 0 )
+		printf("memory error or different object for the same string: %ld\n", error_cnt);
+
+	/* pointer identity across the threads and content of the objects */
+	for( i = 0; i < str_cnt; i++ )
+	{
+		bytes += len_list[i] + 1;
+		for( t = 1; t < thread_cnt; t++ )
+			if ( ts[t].result[i] != ts[0].result[i] )
+				break;
+		if ( t < thread_cnt )
+		{
+			printf("string %ld: different objects in thread 0 and %d\n", i, t);
+			error_cnt++;
+			continue;
+		}
+		if ( ts[0].result[i] == NULL || !coIsStr(ts[0].result[i]) || coSize(ts[0].result[i]) != (long)len_list[i]
+			|| memcmp(coStrGet(ts[0].result[i]), str_list[i], len_list[i] + 1) != 0 )
+		{
+			printf("string %ld: wrong object\n", i);
+			error_cnt++;
+		}
+	}
+
+	/* counters */
+	call_cnt = (size_t)str_cnt * thread_cnt * repeat;
+	coStrPoolGetStat(pool, &stat);
+	if ( coStrPoolSize(pool) != str_cnt || stat.misses != (size_t)str_cnt || stat.hits != call_cnt - str_cnt
+		|| stat.bytes != bytes || stat.bytes_saved != bytes * (thread_cnt * repeat - 1) )
+	{
+		printf("wrong counters: size=%ld misses=%zu hits=%zu bytes=%zu bytes_saved=%zu\n", coStrPoolSize(pool), stat.misses, stat.hits, stat.bytes, stat.bytes_saved);
+		error_cnt++;
+	}
+
+	/* a single thread must find all strings */
+	for( i = 0; i < str_cnt; i++ )
+		if ( coStrPoolAdd(pool, str_list[i], len_list[i]) != ts[0].result[i] )
+			error_cnt++;
+	if ( coStrPoolSize(pool) != str_cnt )
+		error_cnt++;
+
+	for( t = 0; t < thread_cnt; t++ )
+		free(ts[t].result);
+	for( i = 0; i < str_cnt; i++ )
+		free(str_list[i]);
+	free(str_list);
+	free(len_list);
+	coDelete(pool);
+	printf("errors=%ld\n", error_cnt);
+	return error_cnt == 0 ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+/*
+
+	writer_test
+
+        (c) 2024 Oliver Kraus
+        https://github.com/olikraus/c-object
+
+        CC BY-SA 4.0  Attribution-ShareAlike 4.0 International        https://creativecommons.org/licenses/by-sa/4.0/
+
+	round trip test for the output writer:
+	- coDblToStr(): strtod() returns the same double and there is no
+	  shorter representation, which is read back as the same double
+	  (special values, subnormals and random bit patterns)
+	- coWriteJSONToMem() output is byte identical to coWriteJSON() into a
+	  FILE (with and without compact and UTF-8 output)
+	- coWriteJSONToGzMem() and coWriteJSONGz() output inflates back to the
+	  coWriteJSONToMem() output
+	- UTF-8 output (plain and gzip) is read back as the same object
+
+	writer_test [-n count]
+
+	Errorlevel:
+		0		all tests passed
+		1		some test failed
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "co.h"
+#include "co_test_util.h"
+
+uint64_t rnd_state = 88172645463325252ULL;
+
+uint64_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 7;
+	rnd_state ^= rnd_state << 17;
+	return rnd_state;
+}
+
+double getDblByBits(uint64_t b)
+{
+	double d;
+	memcpy(&d, &b, sizeof(double));
+	return d;
+}
+
+uint64_t getBitsByDbl(double d)
+{
+	uint64_t b;
+	memcpy(&b, &d, sizeof(double));
+	return b;
+}
+
+/*===================================================================*/
+/* coDblToStr() */
+
+/* number of significant digits of a coDblToStr() result */
+int getDigitCnt(const char *s)
+{
+	int cnt = 0, zero_cnt = 0;
+	while( *s == '-' || *s == '0' || *s == '.' )	// leading zeros are not significant
+		s++;
+	for( ; *s != '\0' && *s != 'e'; s++ )
+	{
+		if ( *s == '.' )
+			continue;
+		if ( *s == '0' )
+			zero_cnt++;	// trailing zeros are not significant
+		else
+			cnt += zero_cnt + 1, zero_cnt = 0;
+	}
+	return cnt;
+}
+
+/* check a single double, return 1 if the result is ok */
+int checkDbl(double d)
+{
+	char s[32];
+	char t[40];
+	char *end;
+	double e;
+	int len, cnt;
+
+	len = coDblToStr(d, s);
+	if ( len != (int)strlen(s) || len >= 32 )
+		return printf("coDblToStr(%.17g): wrong length %d\n", d, len), 0;
+	if ( d != d )
+	{
+		if ( strcmp(s, (getBitsByDbl(d) >> 63) ? "-nan" : "nan") != 0 )
+			return printf("coDblToStr(nan): '%s'\n", s), 0;
+		return 1;
+	}
+	e = strtod(s, &end);
+	if ( *end != '\0' || getBitsByDbl(d) != getBitsByDbl(e) )	// bit compare: -0.0 must not be 0.0
+		return printf("coDblToStr(%.17g): '%s' is read back as %.17g\n", d, s, e), 0;
+	if ( d - d != 0.0 || d == 0.0 )
+		return 1;	// inf and zero: no shortest check
+	cnt = getDigitCnt(s);
+	if ( cnt < 1 || cnt > 17 )
+		return printf("coDblToStr(%.17g): '%s' has %d digits\n", d, s, cnt), 0;
+	if ( cnt > 1 )
+	{
+		sprintf(t, "%.*e", cnt - 2, d);	// cnt-1 significant digits
+		if ( strtod(t, NULL) == d )
+			return printf("coDblToStr(%.17g): '%s' is not the shortest, '%s' is shorter\n", d, s, t), 0;
+	}
+	return 1;
+}
+
+void testDblToStr(long cnt)
+{
+	double special_list[] = {
+		0.0, 1.0, -1.0, 0.1, 0.2, 0.3, 1.0/3.0, 2.0/3.0, 100.0, 1e16, 1e17, 1e21, 1e22, 1e23, 123456789012345680.0,
+		9007199254740991.0, 9007199254740992.0, 9007199254740994.0, 0.000001, 0.0000012345, 1e-7,
+		DBL_MAX, -DBL_MAX, DBL_MIN, -DBL_MIN, DBL_EPSILON, 5e-324, -5e-324, 1e-323, 2.2250738585072009e-308, 4.9406564584124654e-320,
+	};
+	uint64_t bits_list[] = {
+		0x8000000000000000ULL,		// -0.0
+		0x7FF0000000000000ULL,		// inf
+		0xFFF0000000000000ULL,		// -inf
+		0x7FF8000000000000ULL,		// nan
+		0xFFF8000000000000ULL,		// -nan
+		0x7FF0000000000001ULL,		// signaling nan
+		0x0000000000000001ULL,		// smallest subnormal
+		0x000FFFFFFFFFFFFFULL,		// largest subnormal
+		0x0010000000000000ULL,		// smallest normal
+		0x7FEFFFFFFFFFFFFFULL,		// largest normal
+		0x4340000000000000ULL,		// 2^53
+		0x4330000000000001ULL,		// 2^52+1
+	};
+	long i, err = 0;
+	uint64_t b;
+
+	for( i = 0; i < (long)(sizeof(special_list)/sizeof(*special_list)); i++ )
+		err += checkDbl(special_list[i]) == 0;
+	for( i = 0; i < (long)(sizeof(bits_list)/sizeof(*bits_list)); i++ )
+		err += checkDbl(getDblByBits(bits_list[i])) == 0;
+	for( i = 0; i < cnt && err < 10; i++ )
+	{
+		b = rnd();
+		switch( i % 4 )
+		{
+			case 0: break;								// any bit pattern
+			case 1: b &= 0x800FFFFFFFFFFFFFULL; break;	// subnormal
+			case 2: b = (b & 0x801FFFFFFFFFFFFFULL) | 0x3FE0000000000000ULL; break;	// 0.5 .. 2
+			default: b = (uint64_t)(rnd() % 100000000); break;	// small subnormal mantissa
+		}
+		err += checkDbl(getDblByBits(b)) == 0;
+		err += checkDbl((double)(int64_t)(rnd() >> (rnd() % 64))) == 0;	// integer
+		err += checkDbl((double)(long)(rnd() % 1000000) / 1000.0) == 0;	// short decimal
+	}
+	if ( err > 0 )
+		printf("coDblToStr: %ld errors\n", err), error_cnt++;
+}
+
+/*===================================================================*/
+/* JSON output */
+
+/* nested JSON object, larger than the writer buffer */
+co createJSON(void)
+{
+	co root = coNewMap(CO_FREE_VALS|CO_STRDUP);
+	co list = coNewVector(CO_FREE_VALS);
+	co m;
+	char key[32];
+	char s[64];
+	long i;
+	double d;
+
+	for( i = 0; i < 6000; i++ )
+	{
+		m = coNewMap(CO_FREE_VALS|CO_STRDUP);
+		sprintf(s, "name %ld \"q\" \\ /\t\x01 \xc3\xa4\xe2\x82\xac", i);	// escapes and UTF-8
+		coMapAdd(m, "name", coNewStr(CO_STRDUP, s));
+		do
+		{
+			d = getDblByBits(rnd());
+		} while( d != d || d - d != 0.0 );	// JSON has no nan and inf
+		coMapAdd(m, "dbl", coNewDbl(d));
+		coMapAdd(m, "int", coNewDbl((double)(long)(rnd() % 2000001) - 1000000));
+		coMapAdd(m, "neg_zero", coNewDbl(getDblByBits(0x8000000000000000ULL)));
+		coMapAdd(m, "subnormal", coNewDbl(getDblByBits(rnd() & 0x000FFFFFFFFFFFFFULL)));
+		coMapAdd(m, "flag", coNewBool(i & 1));
+		coMapAdd(m, "empty", coNewVector(CO_FREE_VALS));
+		coVectorAdd(list, m);
+	}
+	coMapAdd(root, "list", list);
+	for( i = 0; i < 100; i++ )
+	{
+		sprintf(key, "key%03ld", i);
+		coMapAdd(root, key, coNewDbl(i / 7.0));
+	}
+	return root;
+}
+
+/* read the complete file, result must be free'd */
+char *readFile(FILE *fp, size_t *len)
+{
+	long size;
+	char *mem;
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	mem = (char *)malloc(size + 1);
+	if ( mem == NULL )
+		return NULL;
+	*len = fread(mem, 1, size, fp);
+	mem[*len] = '\0';
+	return mem;
+}
+
+#ifdef CO_USE_ZLIB
+/* inflate a gzip stream, result must be free'd */
+char *inflateGz(const char *gz, size_t gz_len, size_t *len)
+{
+	z_stream strm;
+	size_t cap = 1024;
+	char *mem = (char *)malloc(cap);
+	char *m;
+	int ret;
+
+	memset(&strm, 0, sizeof(strm));
+	if ( mem == NULL || inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK )
+		return free(mem), NULL;
+	strm.next_in = (Bytef *)gz;
+	strm.avail_in = (uInt)gz_len;
+	*len = 0;
+	do
+	{
+		if ( *len == cap )
+		{
+			m = (char *)realloc(mem, cap * 2);
+			if ( m == NULL )
+				return inflateEnd(&strm), free(mem), NULL;
+			mem = m;
+			cap *= 2;
+		}
+		strm.next_out = (Bytef *)(mem + *len);
+		strm.avail_out = (uInt)(cap - *len);
+		ret = inflate(&strm, Z_NO_FLUSH);
+		*len = cap - strm.avail_out;
+	} while( ret == Z_OK );
+	inflateEnd(&strm);
+	if ( ret != Z_STREAM_END || strm.avail_in != 0 )
+		return free(mem), NULL;
+	return mem;
+}
+#endif
+
+void testJSON(cco o, int isCompact, int isUTF8)
+{
+	FILE *fp = tmpfile();
+	size_t mem_len = 0, file_len = 0;
+	char *mem, *file;
+	co p;
+#ifdef CO_USE_ZLIB
+	size_t gz_len = 0, raw_len = 0;
+	char *gz, *raw;
+#endif
+
+	if ( fp == NULL )
+		return perror("tmpfile"), (void)error_cnt++;
+	mem = coWriteJSONToMem(o, isCompact, isUTF8, &mem_len);
+	CHECK(mem != NULL && mem_len == strlen(mem) && mem_len == coWriteJSONSize(o, isCompact, isUTF8));
+	CHECK(mem_len > CO_WRITER_BUF_SIZE);	// flush of the writer buffer is required
+
+	coWriteJSON(o, isCompact, isUTF8, fp);
+	file = readFile(fp, &file_len);
+	if ( file == NULL || file_len != mem_len || memcmp(file, mem, mem_len) != 0 )
+		printf("compact=%d utf8=%d: coWriteJSON() and coWriteJSONToMem() are different\n", isCompact, isUTF8), error_cnt++;
+	free(file);
+
+	p = coReadJSONByString(mem);	// numbers must be read back exactly
+	if ( isUTF8 && isEqual(o, p) == 0 )	// isUTF8==0 writes each byte >= 128 as \u00XX
+		printf("compact=%d utf8=%d: JSON round trip failed\n", isCompact, isUTF8), error_cnt++;
+	coDelete(p);
+
+#ifdef CO_USE_ZLIB
+	gz = coWriteJSONToGzMem(o, isCompact, isUTF8, Z_DEFAULT_COMPRESSION, &gz_len);
+	raw = gz == NULL ? NULL : inflateGz(gz, gz_len, &raw_len);
+	if ( raw == NULL || raw_len != mem_len || memcmp(raw, mem, mem_len) != 0 )
+		printf("compact=%d utf8=%d: coWriteJSONToGzMem() does not inflate to coWriteJSONToMem()\n", isCompact, isUTF8), error_cnt++;
+	free(raw);
+	free(gz);
+
+	fclose(fp);
+	fp = tmpfile();
+	if ( fp == NULL )
+		return perror("tmpfile"), free(mem), (void)error_cnt++;
+	CHECK(coWriteJSONGz(o, isCompact, isUTF8, fp, 1));
+	gz = readFile(fp, &gz_len);
+	raw = gz == NULL ? NULL : inflateGz(gz, gz_len, &raw_len);
+	if ( raw == NULL || raw_len != mem_len || memcmp(raw, mem, mem_len) != 0 )
+		printf("compact=%d utf8=%d: coWriteJSONGz() does not inflate to coWriteJSONToMem()\n", isCompact, isUTF8), error_cnt++;
+	free(raw);
+	free(gz);
+
+	fseek(fp, 0, SEEK_SET);
+	p = coReadJSONByFP(fp);		// gzip is detected
+	if ( isUTF8 && isEqual(o, p) == 0 )
+		printf("compact=%d utf8=%d: gzip round trip failed\n", isCompact, isUTF8), error_cnt++;
+	coDelete(p);
+#endif
+
+	free(mem);
+	fclose(fp);
+}
+
+int main(int argc, char **argv)
+{
+	long cnt = 1000000;
+	co o;
+	int isCompact, isUTF8;
+
+	if ( argc >= 3 && strcmp(argv[1], "-n") == 0 )
+		cnt = atol(argv[2]);
+	testDblToStr(cnt);
+	o = createJSON();
+	for( isCompact = 0; isCompact < 2; isCompact++ )
+		for( isUTF8 = 0; isUTF8 < 2; isUTF8++ )
+			testJSON(o, isCompact, isUTF8);
+	coDelete(o);
+	if ( error_cnt == 0 )
+		printf("writer_test ok\n");
+	return error_cnt == 0 ? 0 : 1;
+}